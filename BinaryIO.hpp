@@ -0,0 +1,63 @@
+#ifndef BINARYIO_HPP
+#define BINARYIO_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+
+/*! @file BinaryIO.hpp
+ * Functions to write and read values and arrays in the byte order of the machine, for the binary files.
+ * The arrays are followed by zeros up to a multiple of 8 bytes, so an array which starts at a multiple of 8
+ * in the file can be used in place when the file is mapped in memory.
+ */
+
+constexpr size_t binaryAlignment(8); //!< the arrays of the binary files start at a multiple of this number of bytes
+
+template<typename T>
+void writeValue(std::ostream& out, const T& value)
+{
+	out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(std::istream& in, T& value)
+{
+	return bool(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/*!
+ * Writes zeros until the position is a multiple of binaryAlignment
+ */
+inline void writePadding(std::ostream& out)
+{
+	const char zeros[binaryAlignment] = {0};
+	const size_t position(out.tellp());
+	out.write(zeros, (binaryAlignment - position%binaryAlignment)%binaryAlignment);
+}
+
+/*!
+ * Skips the zeros written by writePadding
+ */
+inline bool readPadding(std::istream& in)
+{
+	const size_t position(in.tellg());
+	return bool(in.ignore((binaryAlignment - position%binaryAlignment)%binaryAlignment));
+}
+
+template<typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values)
+{
+	out.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+	writePadding(out);
+}
+
+/*!
+ * Reads an array written by writeArray, the vector must already have the size of the array
+ */
+template<typename T>
+bool readArray(std::istream& in, std::vector<T>& values)
+{
+	return in.read(reinterpret_cast<char*>(values.data()), values.size()*sizeof(T)) and readPadding(in);
+}
+
+#endif
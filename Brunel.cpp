@@ -0,0 +1,109 @@
+#include "Brunel.h"
+#include "BrunelSimulator.hpp"
+#include "Configuration.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <new>
+#include <exception>
+
+using namespace std;
+
+//the C type is the C++ class, no exception goes back to C
+struct brunel_simulator {
+	BrunelSimulator simulator; //!< simulator of the C interface
+};
+
+brunel_simulator* brunel_create(const char* parameters)
+{
+	Configuration configuration;
+	istringstream assignments(parameters ? parameters : "");
+	string assignment;
+	while(assignments >> assignment) {
+		if(!configuration.set(assignment)) {
+			return nullptr;
+		}
+	}
+	brunel_simulator* simulator(new (nothrow) brunel_simulator);
+	if(simulator == nullptr) {
+		cerr << "Not enough memory for the simulator" << endl;
+		return nullptr;
+	}
+	try {
+		if(simulator->simulator.create(configuration)) {
+			return simulator;
+		}
+	} catch(const bad_alloc&) {
+		cerr << "Not enough memory for the network" << endl;
+	} catch(const exception& error) {
+		cerr << "Error creating the network: " << error.what() << endl;
+	}
+	delete simulator;
+	return nullptr;
+}
+
+void brunel_destroy(brunel_simulator* simulator)
+{
+	delete simulator;
+}
+
+int brunel_set_parameters(brunel_simulator* simulator, double g, double etha)
+{
+	try {
+		return simulator->simulator.setParameters(g, etha) ? 1 : 0;
+	} catch(const exception& error) {
+		cerr << "Error setting the parameters: " << error.what() << endl;
+		return 0;
+	}
+}
+
+int brunel_run(brunel_simulator* simulator, unsigned long steps)
+{
+	try {
+		return simulator->simulator.run(steps) ? 1 : 0;
+	} catch(const bad_alloc&) {
+		cerr << "Not enough memory for the spikes" << endl;
+		return 0;
+	} catch(const exception& error) { //the threads of the simulation couldn't be created
+		cerr << "Error running the simulation: " << error.what() << endl;
+		return 0;
+	}
+}
+
+unsigned long brunel_step(const brunel_simulator* simulator)
+{
+	return simulator->simulator.getStep();
+}
+
+unsigned long brunel_size(const brunel_simulator* simulator)
+{
+	return simulator->simulator.getSize().total();
+}
+
+size_t brunel_spikes(const brunel_simulator* simulator, const uint32_t** spikes)
+{
+	const vector<uint32_t>& kept(simulator->simulator.getSpikes());
+	*spikes = kept.data();
+	return kept.size()/2;
+}
+
+double brunel_mean_rate(const brunel_simulator* simulator, unsigned long first, unsigned long last)
+{
+	return simulator->simulator.getMeanRate(first, last);
+}
+
+double brunel_mean_weight(const brunel_simulator* simulator)
+{
+	const Plasticity* plasticity(simulator->simulator.getPlasticity());
+	return plasticity ? plasticity->getMeanWeight() : 0.0;
+}
+
+int brunel_save(const brunel_simulator* simulator, const char* fileName)
+{
+	try {
+		return simulator->simulator.save(fileName) ? 1 : 0;
+	} catch(const exception& error) {
+		cerr << "Error writing the checkpoint: " << error.what() << endl;
+		return 0;
+	}
+}
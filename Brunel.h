@@ -0,0 +1,86 @@
+#ifndef BRUNEL_H
+#define BRUNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @file Brunel.h
+ * C interface of libbrunel, for the programs and the languages which can't use BrunelSimulator directly.
+ * A simulator is created from parameters "key=value" separated by spaces (the keys of Configuration.hpp),
+ * then runs step by step; the spikes and the rates of the last run are read in memory. The functions which can
+ * fail return 1 on success and 0 on failure, the error is written on the standard error.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct brunel_simulator brunel_simulator; /*!< a network and its simulation, only used through the functions */
+
+/*!
+ * @param parameters: "key=value" separated by spaces, as "neurons=1000 g=5 etha=2 seed=42", or NULL
+ * @return a new simulator, NULL if a parameter is not valid
+ */
+brunel_simulator* brunel_create(const char* parameters);
+
+/*!
+ * @param simulator: a simulator created by brunel_create, or NULL
+ * Destroys the simulator and its network
+ */
+void brunel_destroy(brunel_simulator* simulator);
+
+/*!
+ * @param g, etha: the parameters of the graph
+ * Sets the relative strength of the inhibitory connections and the rate of the random spikes
+ * @return 1 on success, 0 if etha is negative or a parameter is not a finite number
+ */
+int brunel_set_parameters(brunel_simulator* simulator, double g, double etha);
+
+/*!
+ * @param steps: the number of steps to simulate after the current step
+ * Makes the network evolve and keeps the spikes of these steps
+ * @return 1 on success, 0 on failure
+ */
+int brunel_run(brunel_simulator* simulator, unsigned long steps);
+
+/*!
+ * @return the next step to simulate
+ */
+unsigned long brunel_step(const brunel_simulator* simulator);
+
+/*!
+ * @return the number of neurons of the network
+ */
+unsigned long brunel_size(const brunel_simulator* simulator);
+
+/*!
+ * @param spikes: receives the address of the spikes of the last run, the time and the index of each spike one
+ * after the other, valid until the next run
+ * @return the number of spikes
+ */
+size_t brunel_spikes(const brunel_simulator* simulator, const uint32_t** spikes);
+
+/*!
+ * @param first, last: the neurons from first to last (excluded)
+ * @return the mean firing rate of the neurons during the last run, in Hz
+ */
+double brunel_mean_rate(const brunel_simulator* simulator, unsigned long first, unsigned long last);
+
+/*!
+ * @return the mean weight of the plastic synapses in mV (parameter plasticity=stdp), 0 if the synapses are static
+ */
+double brunel_mean_weight(const brunel_simulator* simulator);
+
+/*!
+ * @param fileName: the name of the checkpoint to write
+ * Writes a checkpoint of the network at the current step, it is restored with the parameter restore
+ * @return 1 on success, 0 on failure
+ */
+int brunel_save(const brunel_simulator* simulator, const char* fileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
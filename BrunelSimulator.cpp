@@ -0,0 +1,249 @@
+#include "BrunelSimulator.hpp"
+#include "Simulation.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <thread>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+BrunelSimulator::BrunelSimulator()
+	:transport(nullptr), threads(1), step(0), runSteps(0)
+{}
+
+bool BrunelSimulator::create(const Configuration& configuration, SpikeTransport* spikeTransport)
+{
+	NetworkSize size;
+	if(!configuration.getNetworkSize(size)) {
+		return false;
+	}
+	const string precision(configuration.getString("precision", "double"));
+	if(precision != "double" and precision != "float") {
+		cerr << "Invalid precision " << precision << ", it must be double or float" << endl;
+		return false;
+	}
+	const string ringBuffers(configuration.getString("ring_buffers", "amplitudes"));
+	if(ringBuffers != "amplitudes" and ringBuffers != "counts") {
+		cerr << "Invalid ring buffers " << ringBuffers << ", they must be amplitudes or counts" << endl;
+		return false;
+	}
+	const string connections(configuration.getString("connections", "stored"));
+	if(connections != "stored" and connections != "procedural") {
+		cerr << "Invalid connections " << connections << ", they must be stored or procedural" << endl;
+		return false;
+	}
+	const string scheduling(configuration.getString("scheduling", "all"));
+	if(scheduling != "all" and scheduling != "active") {
+		cerr << "Invalid scheduling " << scheduling << ", it must be all or active" << endl;
+		return false;
+	}
+	const string synapses(configuration.getString("plasticity", "static"));
+	if(synapses != "static" and synapses != "stdp") {
+		cerr << "Invalid plasticity " << synapses << ", it must be static or stdp" << endl;
+		return false;
+	}
+	StdpParameters stdp(defaultStdp);
+	if(synapses == "stdp") { //the weights are kept with the stored connections and added in the ring buffers
+		if(connections != "stored" or ringBuffers != "amplitudes") {
+			cerr << "The plasticity is only made with the stored connections and the ring buffers of amplitudes" << endl;
+			return false;
+		}
+		if(configuration.has("checkpoint")) {
+			cerr << "The checkpoints are only made with static synapses" << endl;
+			return false;
+		}
+		if(!configuration.getStdpParameters(stdp)) {
+			return false;
+		}
+	}
+
+	//a checkpoint gives the size and the seed of the network
+	unsigned int seed(configuration.getUnsigned("seed", random_device()()));
+	const string restoreName(configuration.getString("restore"));
+	if(!restoreName.empty() or configuration.has("checkpoint")) {
+		if(spikeTransport) {
+			cerr << "The checkpoints are only made with one process" << endl;
+			return false;
+		}
+		if(precision != "double") {
+			cerr << "The checkpoints are only made in double precision" << endl;
+			return false;
+		}
+		if(ringBuffers != "amplitudes") {
+			cerr << "The checkpoints are only made with the ring buffers of amplitudes" << endl;
+			return false;
+		}
+		if(!restoreName.empty() and !Network::readCheckpoint(restoreName, size, seed)) {
+			return false;
+		}
+	}
+	plasticity.reset(); //its connections belong to the previous network
+	single.reset();
+	network.reset(new Network(size, seed));
+	transport = spikeTransport;
+	threads = max(1ul, configuration.getUnsigned("threads", thread::hardware_concurrency()));
+	step = 0;
+	runSteps = 0;
+	spikes.clear();
+	counts.assign(size.total(), 0);
+
+	if(!restoreName.empty()) { //the state, g, etha and the connections are in the checkpoint
+		if(!network->restore(restoreName, step)) {
+			return false;
+		}
+		if(configuration.has("g")) { //a new experiment can start from the state with other parameters
+			network->getPopulation().setG(configuration.getDouble("g"));
+		}
+		if(configuration.has("etha")) {
+			network->getPopulation().setEtha(configuration.getDouble("etha"));
+		}
+	} else {
+		if(configuration.has("g") and configuration.has("etha")) {
+			network->initializeNetwork(configuration.getDouble("g"), configuration.getDouble("etha"));
+		}
+		if(connections == "procedural") {
+			network->instaureProceduralConnections(); //1250 connections on average, nothing is stored
+		} else { //only the connections towards the neurons of the process are kept
+			const unsigned long first(transport ? Simulation::partition(size.total(), transport->getRank(), transport->getProcesses()) : 0);
+			const unsigned long last(transport ? Simulation::partition(size.total(), transport->getRank()+1, transport->getProcesses()) : size.total());
+			network->instaureConnections(first, last);
+		}
+	}
+
+	if(precision == "float") { //the neurons in single precision have the parameters and the connections of the network
+		single.reset(new FloatNeuronPopulation(size.total(), size.excitatory, seed));
+		single->setG(network->getPopulation().getG());
+		single->setEtha(network->getPopulation().getEtha());
+		if(connections == "procedural") {
+			single->setConnectivity(network->getProceduralConnectivity());
+		} else {
+			single->setConnectivity(network->getConnectivity());
+		}
+	}
+	if(ringBuffers == "counts") { //the spikes of each group are counted
+		single ? single->setRingBufferType(COUNT_RING_BUFFER) : network->getPopulation().setRingBufferType(COUNT_RING_BUFFER);
+	}
+	if(scheduling == "active") { //only the neurons which integrate get random spikes
+		single ? single->setScheduling(ACTIVE_NEURONS_SCHEDULING) : network->getPopulation().setScheduling(ACTIVE_NEURONS_SCHEDULING);
+	}
+	if(synapses == "stdp") { //the weights start at the amplitudes of the groups
+		plasticity.reset(new Plasticity(network->getConnectivity(), network->getPopulation().getGroups(), stdp));
+		single ? single->setPlasticity(*plasticity) : network->getPopulation().setPlasticity(*plasticity);
+	}
+	return true;
+}
+
+bool BrunelSimulator::setParameters(double g, double etha)
+{
+	assert(network);
+	if(!isfinite(g) or !isfinite(etha) or etha < 0.0) { //the rate of the random spikes is etha times the threshold rate
+		cerr << "Invalid parameters g = " << g << " and etha = " << etha << ", etha must be positive" << endl;
+		return false;
+	}
+	network->initializeNetwork(g, etha);
+	if(single) {
+		single->setG(g);
+		single->setEtha(etha);
+	}
+	return true;
+}
+
+void BrunelSimulator::addRecorder(NeuronRecorder& recorder)
+{
+	assert(network);
+	single ? single->addRecorder(recorder) : network->getPopulation().addRecorder(recorder);
+}
+
+bool BrunelSimulator::run(unsigned long steps)
+{
+	return run(steps, Recorder());
+}
+
+bool BrunelSimulator::run(unsigned long steps, const Recorder& record)
+{
+	assert(network);
+	return single ? simulate(*single, steps, record) : simulate(network->getPopulation(), steps, record);
+}
+
+template<typename Real>
+bool BrunelSimulator::simulate(BasicNeuronPopulation<Real>& population, unsigned long steps, const Recorder& record)
+{
+	spikes.clear();
+	fill(counts.begin(), counts.end(), 0);
+	BasicSimulation<Real> simulation(population, threads, transport); //the neurons are shared between the threads (and processes)
+	const bool success(simulation.run(step, step+steps, 0.0, [&](unsigned long n, const vector<uint32_t>& s) {
+		for(auto i : s) {
+			++counts[i];
+		}
+		if(record) {
+			record(n, s);
+			return;
+		}
+		for(auto i : s) {
+			spikes.push_back(n);
+			spikes.push_back(i);
+		}
+	}));
+	step += steps;
+	runSteps = steps;
+	return success;
+}
+
+bool BrunelSimulator::save(const string& fileName) const
+{
+	assert(network);
+	if(transport or single) {
+		cerr << "The checkpoints are only made with one process in double precision" << endl;
+		return false;
+	}
+	return network->save(fileName, step);
+}
+
+////////////////GETTERS//////////////////////
+
+unsigned long BrunelSimulator::getStep() const
+{
+	return step;
+}
+
+const NetworkSize& BrunelSimulator::getSize() const
+{
+	assert(network);
+	return network->getSize();
+}
+
+const Network& BrunelSimulator::getNetwork() const
+{
+	assert(network);
+	return *network;
+}
+
+const Plasticity* BrunelSimulator::getPlasticity() const
+{
+	return plasticity.get();
+}
+
+const vector<uint32_t>& BrunelSimulator::getSpikes() const
+{
+	return spikes;
+}
+
+double BrunelSimulator::getRate(unsigned long i) const
+{
+	return getMeanRate(i, i+1);
+}
+
+double BrunelSimulator::getMeanRate(unsigned long first, unsigned long last) const
+{
+	assert(first <= last and last <= counts.size());
+	if(first == last or runSteps == 0) {
+		return 0.0;
+	}
+	unsigned long total(0);
+	for(unsigned long i(first); i < last; ++i) {
+		total += counts[i];
+	}
+	return total/((last-first)*runSteps*h*1e-3); //the steps last h ms
+}
@@ -0,0 +1,149 @@
+#ifndef BRUNELSIMULATOR_HPP
+#define BRUNELSIMULATOR_HPP
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include "Network.hpp"
+#include "NeuronPopulation.hpp"
+#include "NeuronRecorder.hpp"
+#include "Plasticity.hpp"
+#include "Configuration.hpp"
+#include "SpikeTransport.hpp"
+
+/*!
+ * @class BrunelSimulator
+ * Class that is the entry point of libbrunel: it builds a network from the parameters of a Configuration, then runs
+ * it step by step and gives the spikes and the rates in memory, without asking anything and without any file.
+ * A program can make and run many simulations one after the other this way. The Neuron executable is a client of
+ * it, which adds the command line, the files of the results and the processes. The keys used are the ones of the
+ * size of the network, seed, threads, precision, ring_buffers, connections (stored or procedural), scheduling, g and etha,
+ * plasticity and its parameters, and restore for a checkpoint. The input current is 0, as in the article. Brunel.h gives the same functions in C.
+ */
+
+class BrunelSimulator {
+
+	public:
+
+	/*!
+	 * Function called at the end of each step with the time and the indexes of the neurons which spiked
+     */
+	typedef std::function<void(unsigned long, const std::vector<uint32_t>&)> Recorder;
+
+	/*!
+     * Constructor of the class BrunelSimulator, there is no network before create
+     */
+	BrunelSimulator();
+
+	/*!
+	 * @param configuration: the parameters of the network and of the run
+	 * @param transport: the exchange of the spikes with the other processes, nullptr if there is only one
+	 * Builds the network: a checkpoint is restored if restore is given, else the connections are drawn from the seed
+	 * (by default a random one), only towards the neurons of this process. g and etha are set if they are given.
+	 * With plasticity=stdp the synapses of the excitatory neurons get a weight which changes with the spikes.
+	 * @return false if a parameter is not valid or the checkpoint can't be read
+     */
+	bool create(const Configuration& configuration, SpikeTransport* transport = nullptr);
+
+	/*!
+	 * @param g, etha: the parameters of the graph
+	 * Sets the relative strength of the inhibitory connections and the rate of the random spikes
+	 * @return false if they are not finite numbers or etha is negative, nothing is changed
+     */
+	bool setParameters(double g, double etha);
+
+	/*!
+	 * @param recorder: a recorder of some neurons, it is not copied
+	 * Attaches a recorder to the population which is simulated
+     */
+	void addRecorder(NeuronRecorder& recorder);
+
+	/*!
+	 * @param steps: the number of steps to simulate after the current step
+	 * Makes the network evolve, the spikes of these steps are kept for getSpikes and the rates
+	 * @return false if the spikes couldn't be exchanged with the other processes
+     */
+	bool run(unsigned long steps);
+
+	/*!
+	 * @param steps: the number of steps to simulate after the current step
+	 * @param record: function called with the spikes of each step, in order, instead of keeping them
+	 * Makes the network evolve, only the rates are kept
+	 * @return false if the spikes couldn't be exchanged with the other processes
+     */
+	bool run(unsigned long steps, const Recorder& record);
+
+	/*!
+	 * @param fileName: the name of the checkpoint to write
+	 * Writes a checkpoint of the network at the current step, it is restored with the key restore
+	 * @return false if the file can't be written or the network can't be saved (see Network::save)
+     */
+	bool save(const std::string& fileName) const;
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Getter for the next step to simulate
+	 * @return step
+     */
+	unsigned long getStep() const;
+
+	/*!
+	 * Getter for the number of neurons and of connections of the network
+	 * @return the size of the network
+     */
+	const NetworkSize& getSize() const;
+
+	/*!
+	 * Getter for the network, with its connections and its population in double precision
+	 * @return network
+     */
+	const Network& getNetwork() const;
+
+	/*!
+	 * Getter for the plasticity of the synapses
+	 * @return the plasticity, nullptr if the synapses are static
+     */
+	const Plasticity* getPlasticity() const;
+
+	/*!
+	 * Getter for the spikes of the last run
+	 * @return the time and the index of each spike, one after the other
+     */
+	const std::vector<uint32_t>& getSpikes() const;
+
+	/*!
+	 * @param i: the index of a neuron
+	 * @return the firing rate of the neuron during the last run, in Hz
+     */
+	double getRate(unsigned long i) const;
+
+	/*!
+	 * @param first, last: the neurons from first to last (excluded)
+	 * @return the mean firing rate of the neurons during the last run, in Hz
+     */
+	double getMeanRate(unsigned long first, unsigned long last) const;
+
+	private:
+
+	/*!
+	 * @param population: the population simulated, in its precision
+	 * Runs the steps on the population, counts the spikes and keeps them or gives them to record
+     */
+	template<typename Real>
+	bool simulate(BasicNeuronPopulation<Real>& population, unsigned long steps, const Recorder& record);
+
+	std::unique_ptr<Network> network; //!< network with the connections and the population in double precision
+	std::unique_ptr<FloatNeuronPopulation> single; //!< population simulated in single precision, nullptr in double
+	std::unique_ptr<Plasticity> plasticity; //!< weights of the connections of the network, nullptr if they are static
+	SpikeTransport* transport; //!< exchange of the spikes with the other processes, nullptr if there is only one
+	unsigned int threads; //!< number of threads of a run
+	unsigned long step; //!< next step to simulate
+	unsigned long runSteps; //!< number of steps of the last run
+	std::vector<uint32_t> spikes; //!< time and index of the spikes of the last run
+	std::vector<uint32_t> counts; //!< number of spikes of each neuron during the last run
+
+};
+
+#endif
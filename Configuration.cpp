@@ -0,0 +1,236 @@
+#include "Configuration.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+	const string knownKeys[] = {"neurons", "excitatory_fraction", "connection_probability", "excitatory_connections",
+								"inhibitory_connections", "g", "etha", "seed", "threads", "spikes", "processes",
+								"steps", "checkpoint", "checkpoint_step", "restore", "metrics", "metrics_format",
+								"metrics_interval", "precision", "ring_buffers", "record_spikes", "record_potentials",
+								"record_start", "record_stop", "record_stride", "connections", "scheduling", "plasticity",
+								"stdp_potentiation", "stdp_depression", "stdp_tau_plus", "stdp_tau_minus",
+								"stdp_max_weight"}; //!< keys of the parameters
+
+	const string unsignedKeys[] = {"neurons", "excitatory_connections", "inhibitory_connections", "seed", "threads",
+								   "processes", "steps", "checkpoint_step", "metrics_interval", "record_start",
+								   "record_stop", "record_stride"}; //!< keys of the positive integers
+
+	const string realKeys[] = {"excitatory_fraction", "connection_probability", "g", "etha", "stdp_potentiation",
+							   "stdp_depression", "stdp_tau_plus", "stdp_tau_minus", "stdp_max_weight"}; //!< keys of the real numbers
+
+	/*!
+	 * @param text: a real number, without anything after it; value: receives the number
+	 * @return false if the text is not a finite number
+     */
+	bool readReal(const string& text, double& value)
+	{
+		char* end(nullptr);
+		value = strtod(text.c_str(), &end);
+		return end != text.c_str() and *end == '\0' and isfinite(value);
+	}
+
+	/*!
+	 * @param text: a positive integer in base 10, without anything after it; value: receives the integer
+	 * @return false if the text is not an integer, has a sign or is too large
+     */
+	bool readUnsigned(const string& text, unsigned long& value)
+	{
+		char* end(nullptr);
+		errno = 0;
+		value = strtoul(text.c_str(), &end, 10);
+		return !text.empty() and isdigit(static_cast<unsigned char>(text[0])) and *end == '\0' and errno != ERANGE;
+	}
+
+	/*!
+	 * @return the text without the spaces at the beginning and at the end
+     */
+	string trim(const string& text)
+	{
+		const size_t first(text.find_first_not_of(" \t\r"));
+		if(first == string::npos) {
+			return "";
+		}
+		return text.substr(first, text.find_last_not_of(" \t\r")-first+1);
+	}
+
+	/*!
+	 * @param text: indexes and ranges "first-last" (last excluded) separated by commas; size: the number of neurons
+	 * @param neurons: receives the indexes, in increasing order and without duplicates
+	 * @return false if the text is not valid or has an index larger than the network
+     */
+	bool readNeurons(const string& text, unsigned long size, vector<uint32_t>& neurons)
+	{
+		istringstream items(text);
+		string item;
+		while(getline(items, item, ',')) {
+			const size_t dash(item.find('-'));
+			char* end(nullptr);
+			const unsigned long first(strtoul(item.c_str(), &end, 10));
+			const unsigned long last(dash == string::npos ? first+1 : strtoul(item.c_str()+dash+1, nullptr, 10));
+			if(end == item.c_str() or first >= last or last > size) {
+				return false;
+			}
+			for(unsigned long i(first); i < last; ++i) {
+				neurons.push_back(i);
+			}
+		}
+		sort(neurons.begin(), neurons.end());
+		neurons.erase(unique(neurons.begin(), neurons.end()), neurons.end());
+		return !neurons.empty();
+	}
+
+}
+
+bool Configuration::read(const string& fileName)
+{
+	ifstream file(fileName);
+	if(file.fail()) {
+		cerr << "Error opening the configuration file " << fileName << endl;
+		return false;
+	}
+	string line;
+	for(unsigned long number(1); getline(file, line); ++number) {
+		line = trim(line.substr(0, line.find('#')));
+		if(line.empty()) {
+			continue;
+		}
+		const size_t equal(line.find('='));
+		if(equal == string::npos or !set(trim(line.substr(0, equal)), trim(line.substr(equal+1)))) {
+			cerr << "Invalid line " << number << " of " << fileName << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Configuration::set(const string& assignment)
+{
+	const size_t equal(assignment.find('='));
+	if(equal == string::npos) {
+		cerr << "Invalid parameter " << assignment << ", it must be key=value" << endl;
+		return false;
+	}
+	return set(trim(assignment.substr(0, equal)), trim(assignment.substr(equal+1)));
+}
+
+bool Configuration::set(const string& key, const string& value)
+{
+	if(find(begin(knownKeys), end(knownKeys), key) == end(knownKeys)) {
+		cerr << "Unknown parameter " << key << endl;
+		return false;
+	}
+	//the numbers are checked here, so the getters never read a wrong value
+	double real(0.0);
+	unsigned long integer(0);
+	if(find(begin(unsignedKeys), end(unsignedKeys), key) != end(unsignedKeys) and !readUnsigned(value, integer)) {
+		cerr << "Invalid value " << value << " of " << key << ", it must be a positive integer" << endl;
+		return false;
+	}
+	if(find(begin(realKeys), end(realKeys), key) != end(realKeys) and !readReal(value, real)) {
+		cerr << "Invalid value " << value << " of " << key << ", it must be a number" << endl;
+		return false;
+	}
+	if(key == "etha" and real < 0.0) { //the external frequency is etha times the threshold frequency
+		cerr << "Invalid value " << value << " of etha, it must be positive" << endl;
+		return false;
+	}
+	values[key] = value;
+	return true;
+}
+
+////////////////GETTERS//////////////////////
+
+bool Configuration::has(const string& key) const
+{
+	return values.count(key) > 0;
+}
+
+string Configuration::getString(const string& key, const string& byDefault) const
+{
+	const auto value(values.find(key));
+	return (value != values.end()) ? value->second : byDefault;
+}
+
+double Configuration::getDouble(const string& key, double byDefault) const
+{
+	double value(byDefault);
+	return (has(key) and readReal(getString(key), value)) ? value : byDefault;
+}
+
+unsigned long Configuration::getUnsigned(const string& key, unsigned long byDefault) const
+{
+	unsigned long value(byDefault);
+	return (has(key) and readUnsigned(getString(key), value)) ? value : byDefault;
+}
+
+bool Configuration::getNetworkSize(NetworkSize& size) const
+{
+	const unsigned long neurons(getUnsigned("neurons", brunelSize.total()));
+	const double fraction(getDouble("excitatory_fraction", double(brunelSize.excitatory)/brunelSize.total()));
+	const double probability(getDouble("connection_probability", double(brunelSize.excitatoryConnections)/brunelSize.excitatory));
+
+	size.excitatory = lround(fraction*neurons);
+	size.inhibitory = neurons-size.excitatory;
+	size.excitatoryConnections = getUnsigned("excitatory_connections", lround(probability*size.excitatory));
+	size.inhibitoryConnections = getUnsigned("inhibitory_connections", lround(probability*size.inhibitory));
+
+	if(neurons == 0 or neurons > (static_cast<uint64_t>(1) << 32) or fraction < 0.0 or fraction > 1.0) {
+		cerr << "Invalid size of the network: " << neurons << " neurons, excitatory fraction " << fraction << endl;
+		return false;
+	}
+	if(size.excitatoryConnections > size.excitatory or size.inhibitoryConnections > size.inhibitory) {
+		cerr << "Invalid number of connections: " << size.excitatoryConnections << " excitatory for " << size.excitatory
+			 << " neurons, " << size.inhibitoryConnections << " inhibitory for " << size.inhibitory << " neurons" << endl;
+		return false;
+	}
+	return true;
+}
+
+bool Configuration::getRecorders(unsigned long size, unsigned long start, unsigned long stop, vector<NeuronRecorder>& recorders) const
+{
+	const unsigned long first(getUnsigned("record_start", start));
+	const unsigned long last(getUnsigned("record_stop", stop));
+	const unsigned long stride(getUnsigned("record_stride", 1));
+	if(stride == 0) {
+		cerr << "Invalid record_stride, it must be at least 1" << endl;
+		return false;
+	}
+	const pair<string, RecordedVariable> variables[] = {{"record_spikes", SPIKE_RECORDING}, {"record_potentials", POTENTIAL_RECORDING}};
+	for(auto const& variable : variables) {
+		if(!has(variable.first)) {
+			continue;
+		}
+		vector<uint32_t> neurons;
+		if(!readNeurons(getString(variable.first), size, neurons)) {
+			cerr << "Invalid neurons " << getString(variable.first) << " for " << variable.first << endl;
+			return false;
+		}
+		recorders.push_back(NeuronRecorder(variable.second, neurons, first, last, stride));
+	}
+	return true;
+}
+
+bool Configuration::getStdpParameters(StdpParameters& parameters) const
+{
+	parameters.potentiation = getDouble("stdp_potentiation", defaultStdp.potentiation);
+	parameters.depression = getDouble("stdp_depression", defaultStdp.depression);
+	parameters.tauPlus = getDouble("stdp_tau_plus", defaultStdp.tauPlus);
+	parameters.tauMinus = getDouble("stdp_tau_minus", defaultStdp.tauMinus);
+	parameters.maxWeight = getDouble("stdp_max_weight", defaultStdp.maxWeight);
+	if(parameters.potentiation < 0.0 or parameters.depression < 0.0 or parameters.tauPlus <= 0.0
+	   or parameters.tauMinus <= 0.0 or parameters.maxWeight < 0.0) {
+		cerr << "Invalid parameters of the plasticity: the amplitudes and the largest weight must be positive, "
+			 << "the time constants larger than 0" << endl;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,114 @@
+#ifndef CONFIGURATION_HPP
+#define CONFIGURATION_HPP
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include "Network.hpp"
+#include "NeuronRecorder.hpp"
+#include "Plasticity.hpp"
+
+/*!
+ * @class Configuration
+ * Class that holds the parameters of a run given in a configuration file or on the command line, so the size of
+ * the network can be changed without compiling again. A parameter is a key and a value: a line "key = value" of
+ * a file (what follows # is a comment) or an argument "key=value". The last value given for a key is kept.
+ *
+ * Keys of the size of the network: neurons (12500), excitatory_fraction (0.8), connection_probability (0.1),
+ * excitatory_connections and inhibitory_connections (by default the probability times the number of neurons
+ * of each type). Keys of the run: g, etha, seed, threads (of each process), spikes (name of the binary file of all
+ * the spikes), processes (number of processes which share the neurons), precision (double or float, the type of
+ * the membrane potentials and of the ring buffers), ring_buffers (amplitudes or counts, what the ring buffers hold)
+ * connections (stored or procedural, as the option --procedural) and scheduling (all or active, the neurons
+ * which receive random spikes).
+ * Keys of the checkpoints: checkpoint (file written at checkpoint_step, by default at the end), restore (file
+ * of the state to start from) and steps (number of steps to simulate).
+ * Keys of the instrumentation: metrics (file of the snapshots), metrics_format (json or prometheus) and
+ * metrics_interval (steps between two snapshots).
+ * Keys of the recorders: record_spikes and record_potentials (neurons to record, indexes and ranges "first-last"
+ * with last excluded, separated by commas, as "0-30,100"), record_start and record_stop (window of steps, by default
+ * the whole run) and record_stride (steps between two recorded steps, 1 by default).
+ * Keys of the plasticity: plasticity (static or stdp, the synapses of the excitatory neurons change with the spikes),
+ * stdp_potentiation and stdp_depression (in units of J_excitatory), stdp_tau_plus and stdp_tau_minus (ms) and
+ * stdp_max_weight (in units of J_excitatory).
+ */
+
+class Configuration {
+
+	public:
+
+	/*!
+	 * @param fileName: the name of a configuration file
+	 * Reads the parameters of a file, one "key = value" per line
+	 * @return false if the file can't be read or has an unknown key or an invalid value
+     */
+	bool read(const std::string& fileName);
+
+	/*!
+	 * @param assignment: a parameter "key=value"
+	 * Sets a parameter given on the command line
+	 * @return false if it is not an assignment of a known key with a valid value
+     */
+	bool set(const std::string& assignment);
+
+	/*!
+	 * @param key, value: a known key and its value
+	 * Sets a parameter, the value of a number is checked: an integer without sign or a real number, positive for etha
+	 * @return false if the key is unknown or the value is not valid
+     */
+	bool set(const std::string& key, const std::string& value);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * @param key: the name of a parameter
+	 * @return true if a value was given for the key
+     */
+	bool has(const std::string& key) const;
+
+	/*!
+	 * @param key: the name of a parameter; byDefault: the value if none was given
+	 * @return the value of the parameter as a text
+     */
+	std::string getString(const std::string& key, const std::string& byDefault = "") const;
+
+	/*!
+	 * @param key: the name of a parameter; byDefault: the value if none was given
+	 * @return the value of the parameter as a real number
+     */
+	double getDouble(const std::string& key, double byDefault = 0.0) const;
+
+	/*!
+	 * @param key: the name of a parameter; byDefault: the value if none was given
+	 * @return the value of the parameter as a positive integer
+     */
+	unsigned long getUnsigned(const std::string& key, unsigned long byDefault = 0) const;
+
+	/*!
+	 * @param size: receives the size of the network given by the parameters
+	 * Computes the number of neurons and of connections of each type
+	 * @return false if the size is not possible (more connections than neurons, indexes larger than 32 bits)
+     */
+	bool getNetworkSize(NetworkSize& size) const;
+
+	/*!
+	 * @param size: the number of neurons; start, stop: the steps of the run
+	 * @param recorders: receives a recorder of spikes if record_spikes is given, then one of potentials
+	 * if record_potentials is given, with the window and the stride of the parameters
+	 * @return false if the neurons or the stride are not valid
+     */
+	bool getRecorders(unsigned long size, unsigned long start, unsigned long stop, std::vector<NeuronRecorder>& recorders) const;
+
+	/*!
+	 * @param parameters: receives the parameters of the plasticity, defaultStdp for the ones which are not given
+	 * @return false if an amplitude, a time constant or the largest weight is not valid
+     */
+	bool getStdpParameters(StdpParameters& parameters) const;
+
+	private:
+
+	std::map<std::string, std::string> values; //!< value of each key which was given
+
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "Connectivity.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BinaryIO.hpp"
+
+using namespace std;
+
+Connectivity::Connectivity(unsigned long size)
+	:offsets(size+1, 0), mappedOffsets(nullptr), mappedTargets(nullptr), mappedSize(0), mappedConnections(0)
+{}
+
+void Connectivity::build(const vector<uint32_t>& sources, unsigned long inDegree)
+{
+	assert(sources.size() == size()*inDegree);
+	build(inDegree, [&sources, inDegree](unsigned long n, uint32_t* row) {
+		copy(sources.begin()+n*inDegree, sources.begin()+(n+1)*inDegree, row);
+		return inDegree;
+	});
+}
+
+void Connectivity::build(unsigned long inDegree, const function<unsigned long(unsigned long, uint32_t*)>& draw,
+						 unsigned long first, unsigned long last)
+{
+	const unsigned long numberNeurons(size());
+	last = min(last, numberNeurons);
+	mapping.reset(); //the arrays are used again
+	vector<uint32_t> row(inDegree); //sources of one neuron
+
+	//number of targets of each neuron, offsets[i+1] counts the targets of the neuron i
+	offsets.assign(numberNeurons+1, 0);
+	for(size_t n(0); n < last; ++n) {
+		const unsigned long number(draw(n, row.data()));
+		assert(number <= inDegree);
+		if(n < first) {
+			continue;
+		}
+		for(size_t j(0); j < number; ++j) {
+			assert(row[j] < numberNeurons);
+			++offsets[row[j]+1];
+		}
+	}
+	for(size_t i(0); i < numberNeurons; ++i) {
+		offsets[i+1] += offsets[i];
+	}
+
+	//the connections are placed in order of their target, so the targets of each neuron are sorted
+	targets.assign(offsets[numberNeurons], 0);
+	vector<uint64_t> position(offsets.begin(), offsets.end()-1);
+	for(size_t n(0); n < last; ++n) {
+		const unsigned long number(draw(n, row.data()));
+		if(n < first) {
+			continue;
+		}
+		for(size_t j(0); j < number; ++j) {
+			targets[position[row[j]]++] = n;
+		}
+	}
+}
+
+////////////////GETTERS//////////////////////
+
+unsigned long Connectivity::size() const
+{
+	return mapping ? mappedSize : offsets.size()-1;
+}
+
+unsigned long Connectivity::getNumberConnections() const
+{
+	return mapping ? mappedConnections : targets.size();
+}
+
+unsigned long Connectivity::getNumberTargets(unsigned long i) const
+{
+	return offsetData()[i+1]-offsetData()[i];
+}
+
+const uint32_t* Connectivity::beginTargets(unsigned long i) const
+{
+	return targetData()+offsetData()[i];
+}
+
+const uint32_t* Connectivity::endTargets(unsigned long i) const
+{
+	return targetData()+offsetData()[i+1];
+}
+
+unsigned long Connectivity::getMemory() const
+{
+	return mapping ? 0 : offsets.size()*sizeof(uint64_t) + targets.size()*sizeof(uint32_t);
+}
+
+const uint64_t* Connectivity::offsetData() const
+{
+	return mapping ? mappedOffsets : offsets.data();
+}
+
+const uint32_t* Connectivity::targetData() const
+{
+	return mapping ? mappedTargets : targets.data();
+}
+
+////////////////FILES//////////////////////
+
+void Connectivity::write(ostream& out) const
+{
+	const uint64_t numberNeurons(size()), numberConnections(getNumberConnections());
+	writeValue(out, numberNeurons);
+	writeValue(out, numberConnections);
+	out.write(reinterpret_cast<const char*>(offsetData()), (numberNeurons+1)*sizeof(uint64_t));
+	out.write(reinterpret_cast<const char*>(targetData()), numberConnections*sizeof(uint32_t));
+	writePadding(out);
+}
+
+bool Connectivity::read(istream& in)
+{
+	uint64_t numberNeurons(0), numberConnections(0);
+	if(!readValue(in, numberNeurons) or !readValue(in, numberConnections)) {
+		return false;
+	}
+	mapping.reset();
+	offsets.resize(numberNeurons+1);
+	targets.resize(numberConnections);
+	return readArray(in, offsets) and readArray(in, targets) and offsets.back() == numberConnections;
+}
+
+bool Connectivity::map(const string& fileName, uint64_t position)
+{
+	const int file(open(fileName.c_str(), O_RDONLY));
+	if(file < 0) {
+		return false;
+	}
+	struct stat status;
+	const bool statusRead(fstat(file, &status) == 0);
+	const size_t length(statusRead ? status.st_size : 0);
+	void* const memory(length > 0 ? mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0) : MAP_FAILED);
+	close(file); //the mapping stays after the file is closed
+	if(memory == MAP_FAILED) {
+		return false;
+	}
+	shared_ptr<const char> mapped(static_cast<const char*>(memory), [length](const char* m) {
+		munmap(const_cast<char*>(m), length);
+	});
+
+	//the header, then the offsets and the targets, which start at a multiple of 8 bytes
+	uint64_t header[2];
+	if(position%binaryAlignment != 0 or position+sizeof(header) > length) {
+		return false;
+	}
+	copy(mapped.get()+position, mapped.get()+position+sizeof(header), reinterpret_cast<char*>(header));
+	const uint64_t end(position+sizeof(header)+(header[0]+1)*sizeof(uint64_t)+header[1]*sizeof(uint32_t));
+	if(end > length) {
+		return false;
+	}
+	mappedOffsets = reinterpret_cast<const uint64_t*>(mapped.get()+position+sizeof(header));
+	mappedTargets = reinterpret_cast<const uint32_t*>(mappedOffsets+header[0]+1);
+	if(mappedOffsets[header[0]] != header[1]) {
+		return false;
+	}
+	mappedSize = header[0];
+	mappedConnections = header[1];
+	mapping = mapped;
+	offsets.clear(); //the arrays are replaced by the file
+	targets.clear();
+	offsets.shrink_to_fit();
+	targets.shrink_to_fit();
+	return true;
+}
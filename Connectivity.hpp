@@ -0,0 +1,130 @@
+#ifndef CONNECTIVITY_HPP
+#define CONNECTIVITY_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+/*!
+ * @class Connectivity
+ * Class that stores the connections of the network in compressed sparse row form.
+ * The targets of all the neurons are kept in one array of 32 bits indexes, the targets of the neuron i
+ * are between offsets[i] and offsets[i+1]. The targets of a neuron are sorted in increasing order.
+ * It takes 4 bytes per connection instead of a pointer, and a spiking neuron reads its targets in one contiguous block.
+ */
+
+class Connectivity {
+
+	public:
+
+	/*!
+     * Constructor of the class Connectivity
+     * @param size: the number of neurons of the network, they have no target at the beginning
+     */
+	Connectivity(unsigned long size = 0);
+
+	/*!
+	 * @param sources: the source of each connection, the connection k goes to the neuron k/inDegree
+	 * @param inDegree: the number of connections received by each neuron
+	 * Builds the arrays from the sources chosen for each neuron: the targets of each source are counted,
+	 * the offsets are computed and the targets are placed, in one pass over the connections
+     */
+	void build(const std::vector<uint32_t>& sources, unsigned long inDegree);
+
+	/*!
+	 * @param inDegree: the largest number of connections received by a neuron
+	 * @param draw: function which writes the sources of the neuron n in the array given with n (at most inDegree)
+	 * and returns their number
+	 * Builds the arrays without keeping the sources of all the connections: draw is called for the neurons 0 to
+	 * size-1 in order to count the targets of each source, then a second time to place them, it must give the
+	 * same sources both times. Only the targets are stored, 4 bytes per connection.
+	 * @param first, last: only the connections towards the neurons from first to last (excluded) are kept, draw is
+	 * still called from the neuron 0 so the sources are the same as for the whole network
+     */
+	void build(unsigned long inDegree, const std::function<unsigned long(unsigned long, uint32_t*)>& draw,
+			   unsigned long first = 0, unsigned long last = ~0ul);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Getter for the number of neurons of the network
+	 * @return the number of rows
+     */
+	unsigned long size() const;
+
+	/*!
+	 * Getter for the total number of connections
+	 * @return the size of the array of targets
+     */
+	unsigned long getNumberConnections() const;
+
+	/*!
+	 * Getter for the number of targets of the neuron i
+	 * @return offsets[i+1]-offsets[i]
+     */
+	unsigned long getNumberTargets(unsigned long i) const;
+
+	/*!
+	 * Getter for the first target of the neuron i
+	 * @return a pointer on the first index of the targets of i
+     */
+	const uint32_t* beginTargets(unsigned long i) const;
+
+	/*!
+	 * Getter for the end of the targets of the neuron i
+	 * @return a pointer after the last index of the targets of i
+     */
+	const uint32_t* endTargets(unsigned long i) const;
+
+	/*!
+	 * Getter for the memory used by the connections
+	 * @return the number of bytes of the offsets and the targets
+     */
+	unsigned long getMemory() const;
+
+	/*!
+	 * @param out: a binary file, at a multiple of 8 bytes
+	 * Writes the number of neurons and of connections, the offsets and the targets, in the byte order of the machine
+     */
+	void write(std::ostream& out) const;
+
+	/*!
+	 * @param in: a binary file at the position of the connections written by write
+	 * Reads the connections in the arrays
+	 * @return false if the file ends before
+     */
+	bool read(std::istream& in);
+
+	/*!
+	 * @param fileName: a binary file; position: the position of the connections written by write
+	 * Maps the file in memory and uses the offsets and the targets in place, without reading them: the pages are
+	 * only loaded when they are used and they are shared by all the processes which map the same file
+	 * @return false if the file can't be mapped or is too short
+     */
+	bool map(const std::string& fileName, uint64_t position);
+
+	private:
+
+	/*!
+	 * @return the offsets, in the arrays or in the mapped file
+     */
+	const uint64_t* offsetData() const;
+
+	/*!
+	 * @return the targets, in the arrays or in the mapped file
+     */
+	const uint32_t* targetData() const;
+
+	std::vector<uint64_t> offsets; //!< position of the first target of each neuron, size+1 values
+	std::vector<uint32_t> targets; //!< targets of all the neurons, one after the other
+	std::shared_ptr<const char> mapping; //!< mapped file, the arrays are not used while it is not null
+	const uint64_t* mappedOffsets; //!< offsets in the mapped file
+	const uint32_t* mappedTargets; //!< targets in the mapped file
+	unsigned long mappedSize; //!< number of neurons in the mapped file
+	unsigned long mappedConnections; //!< number of connections in the mapped file
+
+};
+
+#endif
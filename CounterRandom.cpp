@@ -0,0 +1,82 @@
+#include "CounterRandom.hpp"
+#include <iostream>
+
+using namespace std;
+
+constexpr uint32_t multiplier0(0xD2511F53); //!< constants of the Philox4x32 rounds
+constexpr uint32_t multiplier1(0xCD9E8D57);
+constexpr uint32_t weyl0(0x9E3779B9); //!< increments of the key after each round
+constexpr uint32_t weyl1(0xBB67AE85);
+constexpr int rounds(10); //!< number of rounds, 10 is the standard value
+
+CounterRandom::CounterRandom(uint64_t s)
+	:seed(s)
+{}
+
+uint64_t CounterRandom::getSeed() const
+{
+	return seed;
+}
+
+array<uint32_t, 4> CounterRandom::operator()(uint64_t stream, uint64_t counter) const
+{
+	array<uint32_t, 4> x = {{static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32),
+							 static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32)}};
+	uint32_t key0(static_cast<uint32_t>(seed));
+	uint32_t key1(static_cast<uint32_t>(seed >> 32));
+
+	for(int r(0); r < rounds; ++r) {
+		const uint64_t product0(static_cast<uint64_t>(multiplier0)*x[0]);
+		const uint64_t product1(static_cast<uint64_t>(multiplier1)*x[2]);
+		x = {{static_cast<uint32_t>(product1 >> 32) ^ x[1] ^ key0, static_cast<uint32_t>(product1),
+			  static_cast<uint32_t>(product0 >> 32) ^ x[3] ^ key1, static_cast<uint32_t>(product0)}};
+		key0 += weyl0;
+		key1 += weyl1;
+	}
+	return x;
+}
+
+double CounterRandom::uniform(uint64_t stream, uint64_t counter) const
+{
+	const array<uint32_t, 4> x((*this)(stream, counter));
+	const uint64_t bits((static_cast<uint64_t>(x[0]) << 21) ^ (x[1] >> 11)); //53 random bits
+	return bits*(1.0/9007199254740992.0); //divided by 2^53
+}
+
+void CounterRandom::fill(uint32_t* words, uint64_t firstStream, unsigned long numberStreams, uint64_t counter) const
+{
+	constexpr unsigned long lanes(8);
+	uint32_t x0[lanes], x1[lanes], x2[lanes], x3[lanes];
+
+	for(unsigned long s(0); s < numberStreams; s += lanes) {
+		for(size_t j(0); j < lanes; ++j) {
+			const uint64_t stream(firstStream+s+j);
+			x0[j] = static_cast<uint32_t>(stream);
+			x1[j] = static_cast<uint32_t>(stream >> 32);
+			x2[j] = static_cast<uint32_t>(counter);
+			x3[j] = static_cast<uint32_t>(counter >> 32);
+		}
+		uint32_t key0(static_cast<uint32_t>(seed));
+		uint32_t key1(static_cast<uint32_t>(seed >> 32));
+
+		for(int r(0); r < rounds; ++r) {
+			for(size_t j(0); j < lanes; ++j) { //same round as in operator(), on all the lanes
+				const uint64_t product0(static_cast<uint64_t>(multiplier0)*x0[j]);
+				const uint64_t product1(static_cast<uint64_t>(multiplier1)*x2[j]);
+				x0[j] = static_cast<uint32_t>(product1 >> 32) ^ x1[j] ^ key0;
+				x1[j] = static_cast<uint32_t>(product1);
+				x2[j] = static_cast<uint32_t>(product0 >> 32) ^ x3[j] ^ key1;
+				x3[j] = static_cast<uint32_t>(product0);
+			}
+			key0 += weyl0;
+			key1 += weyl1;
+		}
+
+		for(size_t j(0); j < lanes and s+j < numberStreams; ++j) {
+			words[4*(s+j)] = x0[j];
+			words[4*(s+j)+1] = x1[j];
+			words[4*(s+j)+2] = x2[j];
+			words[4*(s+j)+3] = x3[j];
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef COUNTERRANDOM_HPP
+#define COUNTERRANDOM_HPP
+
+#include <iostream>
+#include <array>
+#include <cstdint>
+
+/*!
+ * @class CounterRandom
+ * Class that gives random numbers which only depend on a key and a counter (Philox4x32-10 generator).
+ * The key is the seed of the simulation and the counter is made of a stream (for instance the index of a neuron)
+ * and a position in that stream (for instance the step). There is no state to update: the numbers of a neuron
+ * at a step are always the same, whatever the order of the calls and the thread which makes them.
+ */
+
+class CounterRandom {
+
+	public:
+
+	/*!
+     * Constructor of the class CounterRandom
+     * @param seed: the key of the generator
+     */
+	CounterRandom(uint64_t seed = 0);
+
+	/*!
+	 * Getter for the seed of the generator
+	 * @return seed
+     */
+	uint64_t getSeed() const;
+
+	/*!
+	 * @param stream, counter: the position of the numbers
+	 * Computes the 4 random words of the position, with 10 rounds of Philox
+	 * @return 4 random integers of 32 bits
+     */
+	std::array<uint32_t, 4> operator()(uint64_t stream, uint64_t counter) const;
+
+	/*!
+	 * @param stream, counter: the position of the number
+	 * Gives a random number uniformly distributed in [0, 1) with 53 random bits
+	 * @return the random number
+     */
+	double uniform(uint64_t stream, uint64_t counter) const;
+
+	/*!
+	 * @param words: array which receives 4 words per stream
+	 * @param firstStream, numberStreams: the streams from firstStream to firstStream+numberStreams (excluded)
+	 * @param counter: the same position for all the streams
+	 * Computes the 4 words of several streams at once, words[4*j+w] is the word w of the stream firstStream+j.
+	 * The rounds are made on 8 streams at a time stored in separate arrays, so the loops can be vectorized.
+     */
+	void fill(uint32_t* words, uint64_t firstStream, unsigned long numberStreams, uint64_t counter) const;
+
+	private:
+
+	uint64_t seed; //!< key of the generator
+
+};
+
+#endif
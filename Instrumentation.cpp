@@ -0,0 +1,138 @@
+#include "Instrumentation.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+
+namespace {
+
+	const char* const phaseNames[NUMBER_PHASES] = {"noise", "membrane", "delivery", "wait", "exchange", "record",
+												   "write"}; //!< names of the phases in the snapshots
+	const char* const counterNames[NUMBER_COUNTERS] = {"steps", "spikes", "synaptic_events", "refractory_skipped",
+													   "bytes_written"}; //!< names of the counters in the snapshots
+
+}
+
+Instrumentation::Instrumentation()
+	:start(chrono::steady_clock::now())
+{
+	reset();
+}
+
+Instrumentation& Instrumentation::global()
+{
+	static Instrumentation instrumentation;
+	return instrumentation;
+}
+
+void Instrumentation::add(Counter counter, uint64_t n)
+{
+	counts[counter].fetch_add(n, memory_order_relaxed);
+}
+
+void Instrumentation::addTime(Phase phase, uint64_t nanoseconds)
+{
+	times[phase].fetch_add(nanoseconds, memory_order_relaxed);
+}
+
+void Instrumentation::reset()
+{
+	for(auto& time : times) {
+		time.store(0, memory_order_relaxed);
+	}
+	for(auto& count : counts) {
+		count.store(0, memory_order_relaxed);
+	}
+	start = chrono::steady_clock::now();
+}
+
+////////////////GETTERS//////////////////////
+
+uint64_t Instrumentation::getCount(Counter counter) const
+{
+	return counts[counter].load(memory_order_relaxed);
+}
+
+double Instrumentation::getSeconds(Phase phase) const
+{
+	return times[phase].load(memory_order_relaxed)*1e-9;
+}
+
+const char* Instrumentation::getName(Phase phase)
+{
+	return phaseNames[phase];
+}
+
+const char* Instrumentation::getName(Counter counter)
+{
+	return counterNames[counter];
+}
+
+////////////////SNAPSHOTS//////////////////////
+
+void Instrumentation::writeJson(ostream& out, unsigned long step) const
+{
+	const double elapsed(chrono::duration<double>(chrono::steady_clock::now()-start).count());
+	out << "{\"step\": " << step << ", \"elapsed_seconds\": " << elapsed << ", \"enabled\": " << (instrumentationEnabled ? "true" : "false")
+		<< ", \"phase_seconds\": {";
+	for(unsigned int p(0); p < NUMBER_PHASES; ++p) {
+		out << (p > 0 ? ", " : "") << '"' << phaseNames[p] << "\": " << getSeconds(Phase(p));
+	}
+	out << "}, \"counters\": {";
+	for(unsigned int c(0); c < NUMBER_COUNTERS; ++c) {
+		out << (c > 0 ? ", " : "") << '"' << counterNames[c] << "\": " << getCount(Counter(c));
+	}
+	out << "}}\n";
+}
+
+void Instrumentation::writePrometheus(ostream& out, unsigned long step) const
+{
+	out << "# HELP brunel_step Current step of the simulation\n"
+		<< "# TYPE brunel_step gauge\n"
+		<< "brunel_step " << step << '\n'
+		<< "# HELP brunel_elapsed_seconds Time since the start of the run\n"
+		<< "# TYPE brunel_elapsed_seconds gauge\n"
+		<< "brunel_elapsed_seconds " << chrono::duration<double>(chrono::steady_clock::now()-start).count() << '\n'
+		<< "# HELP brunel_phase_seconds_total Time spent in each phase of the step loop, summed over the threads\n"
+		<< "# TYPE brunel_phase_seconds_total counter\n";
+	for(unsigned int p(0); p < NUMBER_PHASES; ++p) {
+		out << "brunel_phase_seconds_total{phase=\"" << phaseNames[p] << "\"} " << getSeconds(Phase(p)) << '\n';
+	}
+	for(unsigned int c(0); c < NUMBER_COUNTERS; ++c) {
+		out << "# TYPE brunel_" << counterNames[c] << "_total counter\n"
+			<< "brunel_" << counterNames[c] << "_total " << getCount(Counter(c)) << '\n';
+	}
+}
+
+bool Instrumentation::snapshot(const string& fileName, MetricsFormat format, unsigned long step) const
+{
+	const string temporary(fileName + ".tmp");
+	{
+		ofstream out(temporary);
+		if(out.fail()) {
+			cerr << "Error opening the file of the metrics " << temporary << endl;
+			return false;
+		}
+		if(format == PROMETHEUS_METRICS) {
+			writePrometheus(out, step);
+		} else {
+			writeJson(out, step);
+		}
+		if(out.fail()) {
+			return false;
+		}
+	}
+	return rename(temporary.c_str(), fileName.c_str()) == 0; //the reader sees the old snapshot or the new one
+}
+
+////////////////PHASE TIMER//////////////////////
+
+PhaseTimer::PhaseTimer(Phase p)
+	:phase(p), start(chrono::steady_clock::now())
+{}
+
+PhaseTimer::~PhaseTimer()
+{
+	Instrumentation::global().addTime(phase, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now()-start).count());
+}
@@ -0,0 +1,162 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/*! @file Instrumentation.hpp
+ * Timers of the phases of the step loop and counters of the simulation. They are only measured when the program
+ * is compiled with BRUNEL_INSTRUMENTATION (cmake -DBRUNEL_INSTRUMENTATION=ON): otherwise the macros BRUNEL_TIME and
+ * BRUNEL_COUNT do nothing and the loop is the same as without them.
+ */
+
+#ifdef BRUNEL_INSTRUMENTATION
+constexpr bool instrumentationEnabled(true); //!< true if the timers and the counters are measured
+#else
+constexpr bool instrumentationEnabled(false); //!< true if the timers and the counters are measured
+#endif
+
+/*!
+ * phases of the step loop, their times are summed over all the threads
+ */
+enum Phase {NOISE_PHASE, MEMBRANE_PHASE, DELIVERY_PHASE, WAIT_PHASE, EXCHANGE_PHASE, RECORD_PHASE, WRITE_PHASE,
+			NUMBER_PHASES};
+
+/*!
+ * counters of the simulation
+ */
+enum Counter {STEPS_COUNTER, SPIKES_COUNTER, EVENTS_COUNTER, REFRACTORY_COUNTER, BYTES_COUNTER, NUMBER_COUNTERS};
+
+/*!
+ * formats of the snapshots of the instrumentation
+ */
+enum MetricsFormat {JSON_METRICS, PROMETHEUS_METRICS};
+
+/*!
+ * @class Instrumentation
+ * Class that holds the times of the phases and the counters of the process. The threads add to them
+ * with atomic operations, once per block of neurons or per epoch, never per neuron.
+ * A snapshot of all the values can be written as a JSON object or as Prometheus text, in a file which is
+ * replaced at once so a scraper never reads half of it.
+ */
+
+class Instrumentation {
+
+	public:
+
+	/*!
+	 * @return the instrumentation of the process
+     */
+	static Instrumentation& global();
+
+	/*!
+	 * @param counter: a counter; n: the number to add
+	 * Adds n to the counter
+     */
+	void add(Counter counter, uint64_t n);
+
+	/*!
+	 * @param phase: a phase; nanoseconds: the time spent in it
+	 * Adds a time to the phase
+     */
+	void addTime(Phase phase, uint64_t nanoseconds);
+
+	/*!
+	 * Sets all the times and the counters to 0 and starts the clock of the run again
+     */
+	void reset();
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * @return the value of the counter
+     */
+	uint64_t getCount(Counter counter) const;
+
+	/*!
+	 * @return the time spent in the phase, in seconds
+     */
+	double getSeconds(Phase phase) const;
+
+	/*!
+	 * @return the name of the phase in the snapshots
+     */
+	static const char* getName(Phase phase);
+
+	/*!
+	 * @return the name of the counter in the snapshots
+     */
+	static const char* getName(Counter counter);
+
+	/////////////////////////SNAPSHOTS///////////////////////
+
+	/*!
+	 * @param out: the stream; step: the current step of the simulation
+	 * Writes all the values in a JSON object on one line
+     */
+	void writeJson(std::ostream& out, unsigned long step) const;
+
+	/*!
+	 * @param out: the stream; step: the current step of the simulation
+	 * Writes all the values in the text format of Prometheus
+     */
+	void writePrometheus(std::ostream& out, unsigned long step) const;
+
+	/*!
+	 * @param fileName: the file of the snapshot; format: JSON_METRICS or PROMETHEUS_METRICS; step: the current step
+	 * Writes the snapshot in a temporary file which then replaces the file
+	 * @return false if the file can't be written
+     */
+	bool snapshot(const std::string& fileName, MetricsFormat format, unsigned long step) const;
+
+	private:
+
+	/*!
+     * Constructor of the class Instrumentation, all the values start at 0
+     */
+	Instrumentation();
+
+	std::atomic<uint64_t> times[NUMBER_PHASES]; //!< time of each phase, in nanoseconds
+	std::atomic<uint64_t> counts[NUMBER_COUNTERS]; //!< value of each counter
+	std::chrono::steady_clock::time_point start; //!< time of the creation or of the last reset
+
+};
+
+/*!
+ * @class PhaseTimer
+ * Class that adds to a phase the time between its construction and its destruction
+ */
+
+class PhaseTimer {
+
+	public:
+
+	/*!
+     * Constructor of the class PhaseTimer, starts the timer
+     * @param p: the phase of the time
+     */
+	PhaseTimer(Phase p);
+
+	/*!
+	 * destructor of the class PhaseTimer, adds the time to the phase
+     */
+	~PhaseTimer();
+
+	private:
+
+	Phase phase; //!< phase of the time
+	std::chrono::steady_clock::time_point start; //!< time of the construction
+
+};
+
+#ifdef BRUNEL_INSTRUMENTATION
+#define BRUNEL_TIME(phase) const PhaseTimer phaseTimer(phase)
+#define BRUNEL_COUNT(counter, n) Instrumentation::global().add(counter, n)
+#else
+#define BRUNEL_TIME(phase)
+#define BRUNEL_COUNT(counter, n) static_cast<void>(n) //a local count is not used, the compiler removes it
+#endif
+
+#endif
@@ -2,65 +2,269 @@
 #include "Neuron.hpp"
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include "BinaryIO.hpp"
 
 using namespace std;
 
-Network::Network()
+Network::Network(unsigned int s)
+	:Network(brunelSize, s)
 {}
 
-array<Neuron*, totalN> Network::getNeurons() const
+Network::Network(const NetworkSize& size, unsigned int s)
+	:seed(s), networkSize(size), inDegrees(2, {size.excitatoryConnections, size.inhibitoryConnections}),
+	 neurons(size.total(), size.excitatory, s), connections(size.total()),
+	 procedural(size.total(), size.excitatory, size.excitatoryConnections, size.inhibitoryConnections, s),
+	 proceduralConnections(false)
+{
+	assert(size.total() <= (static_cast<uint64_t>(1) << 32)); //the indexes of the neurons are 32 bits
+	assert(size.excitatoryConnections <= size.excitatory and size.inhibitoryConnections <= size.inhibitory);
+}
+
+Network::Network(const vector<NeuronGroup>& groups, const vector<vector<unsigned long> >& connectionsOfGroups, unsigned int s)
+	:seed(s), networkSize({groups[0].size, groups.size() > 1 ? groups[1].size : 0, connectionsOfGroups[0][0],
+						   groups.size() > 1 ? connectionsOfGroups[0][1] : 0}),
+	 inDegrees(connectionsOfGroups), neurons(groups, s), connections(neurons.size()),
+	 procedural(networkSize.total(), networkSize.excitatory, networkSize.excitatoryConnections, networkSize.inhibitoryConnections, s),
+	 proceduralConnections(false)
+{
+	assert(neurons.size() <= (static_cast<uint64_t>(1) << 32));
+	assert(inDegrees.size() == groups.size());
+	for(auto const& row : inDegrees) {
+		assert(row.size() == groups.size());
+		for(size_t k(0); k < row.size(); ++k) {
+			assert(row[k] <= groups[k].size);
+		}
+	}
+}
+
+const NetworkSize& Network::getSize() const
+{
+	return networkSize;
+}
+
+unsigned int Network::getSeed() const
+{
+	return seed;
+}
+
+const NeuronPopulation& Network::getPopulation() const
 {
 	return neurons;
 }
 
-void Network::initializeNetwork()
+NeuronPopulation& Network::getPopulation()
+{
+	return neurons;
+}
+
+const Connectivity& Network::getConnectivity() const
+{
+	return connections;
+}
+
+const ProceduralConnectivity& Network::getProceduralConnectivity() const
+{
+	return procedural;
+}
+
+bool Network::initializeNetwork()
 {
-	Neuron n1;
-	n1.setExcitatory(true);
-	Neuron n2;
-	n2.setExcitatory(false);
-	
 	//parameters for different graphs
-	double g; 
-	double etha; 
+	double g(0.0); 
+	double etha(0.0); 
 	cout << "Enter g: ";
 	cin >> g ;
 	cout << "Enter etha: ";
 	cin >> etha;
-	
-	for( size_t i(0); i < neurons.size(); ++i) { //for each neuron of the network
-		if(i < excitatoryNeurons) { //if the number of neurons if lower than the number expected for excitatory neurons (10000) 
-			neurons[i] =  new Neuron(n1); //add an excitatory neuron
-		}
-		else { neurons[i] = new Neuron(n2); } //else an inhibitory one
-		neurons[i]->setG(g);
-		neurons[i]->setEtha(etha);
+	if(!cin or etha < 0.0) { //nothing could be read (an empty input) or not a number
+		cerr << "Invalid g or etha, they must be numbers and etha must be positive" << endl;
+		return false;
 	}
+	initializeNetwork(g, etha);
+	return true;
 }
 
-void Network::instaureConnections()
+void Network::initializeNetwork(double g, double etha)
+{
+	//the first 10000 neurons of the population are excitatory and the others inhibitory,
+	//g and etha are the same for all of them
+	neurons.setG(g);
+	neurons.setEtha(etha);
+}
+
+void Network::instaureConnections(unsigned long first, unsigned long last)
 {
 	//connections between neurons are made and they stay the same for the whole time of the simulation
 	//connections are chosen randomly but each neuron has necessarily 1250 connections
 	// 1000 excitatory and 250 inhibitory
 	
-	random_device rd;
-	mt19937 generator(rd());
+	mt19937 generator(seed);
 
-	uniform_int_distribution<unsigned int> uniformExcitatory(0,excitatoryNeurons-1);
-	uniform_int_distribution<unsigned int> uniformInhibitory(excitatoryNeurons,totalN-1);
-
-	for(auto n : neurons) { //for all neurons, create the connections with the others (1250 connections)
-		
-		for(size_t j(0); j < excitatoryConnections; ++j) {
-			//each chosen excitatory neuron becomes a target of the present one(
-			neurons[uniformExcitatory(generator)]->setTargets(n); 
+	//the sources of a group are drawn among its neurons (the excitatory ones, then the inhibitory ones)
+	const vector<NeuronGroup>& groups(neurons.getGroups());
+	vector<uniform_int_distribution<unsigned int> > uniform;
+	unsigned long groupFirst(0), inDegree(0);
+	for(size_t k(0); k < groups.size(); ++k) {
+		uniform.push_back(uniform_int_distribution<unsigned int>(groupFirst, max(groupFirst+groups[k].size, groupFirst+1)-1));
+		groupFirst += groups[k].size;
+		inDegree = max(inDegree, accumulate(inDegrees[k].begin(), inDegrees[k].end(), 0ul));
+	}
+	
+	//for all neurons, create the connections with the others (1250 connections), the neuron n becomes a target of
+	//each chosen neuron. The connectivity asks them twice, so the generator starts again with the first neuron
+	connections.build(inDegree, [&](unsigned long n, uint32_t* sources) {
+		if(n == 0) {
+			generator.seed(seed);
+			for(auto& distribution : uniform) {
+				distribution.reset();
+			}
 		}
-		for(size_t k(0); k < inhibitoryConnections; ++k) {
-			//each chosen inhibitoryneuron becomes a target of the present one
-			neurons[uniformInhibitory(generator)]->setTargets(n); 
+		const vector<unsigned long>& inDegreesOfGroup(inDegrees[neurons.getGroup(n)]);
+		unsigned long number(0);
+		for(size_t k(0); k < uniform.size(); ++k) {
+			for(size_t j(0); j < inDegreesOfGroup[k]; ++j) {
+				sources[number++] = uniform[k](generator); 
 			}
 		}
+		return number;
+	}, first, last);
+	neurons.setConnectivity(connections);
+	proceduralConnections = false;
+}
+
+void Network::instaureProceduralConnections()
+{
+	assert(hasBrunelGroups());
+	//the targets are drawn by the population when a neuron spikes, the stored connections stay empty
+	neurons.setConnectivity(procedural);
+	proceduralConnections = true;
+}
+
+namespace {
+
+	constexpr char magic[4] = {'B', 'R', 'C', 'K'}; //!< first bytes of a checkpoint
+	constexpr uint32_t version(1); //!< version of the format of the checkpoints
+
+	/*!
+	 * Header of a checkpoint, after the magic bytes
+     */
+	struct CheckpointHeader {
+		uint32_t version; //!< version of the format
+		uint32_t delay; //!< delay D of the connections, the ring buffers have D+1 slots
+		uint64_t step; //!< next step to simulate
+		uint32_t seed; //!< seed of the network
+		uint32_t procedural; //!< 1 if the connections are procedural
+		uint64_t size[4]; //!< excitatory and inhibitory neurons, excitatory and inhibitory connections
+	};
+
+	/*!
+	 * Reads the magic bytes and the header of a checkpoint
+	 * @return false if the file is not a checkpoint of this version
+     */
+	bool readHeader(istream& in, CheckpointHeader& header)
+	{
+		char bytes[4];
+		if(!in.read(bytes, sizeof(bytes)) or !equal(bytes, bytes+4, magic) or !readValue(in, header)
+		   or header.version != version or header.delay != D) {
+			return false;
+		}
+		return true;
+	}
+
+}
+
+bool Network::hasBrunelGroups() const
+{
+	const vector<NeuronGroup>& groups(neurons.getGroups());
+	const vector<NeuronGroup> brunel(brunelGroups(networkSize.excitatory, networkSize.inhibitory));
+	if(groups.size() != brunel.size() or inDegrees[0] != inDegrees[1]) {
+		return false;
+	}
+	for(size_t k(0); k < groups.size(); ++k) {
+		if(groups[k].size != brunel[k].size or groups[k].weight != brunel[k].weight or groups[k].drive != brunel[k].drive
+		   or groups[k].threshold != brunel[k].threshold or groups[k].refractory != brunel[k].refractory) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Network::save(const string& fileName, unsigned long step) const
+{
+	if(!hasBrunelGroups()) {
+		cerr << "The checkpoints are only made for the two groups of the article" << endl;
+		return false;
+	}
+	if(neurons.getRingBufferType() != AMPLITUDE_RING_BUFFER) {
+		cerr << "The checkpoints are only made with the ring buffers of amplitudes" << endl;
+		return false;
+	}
+	if(neurons.getPlasticity() != nullptr) {
+		cerr << "The checkpoints are only made with static synapses, the weights are not saved" << endl;
+		return false;
+	}
+	ofstream file(fileName, ios::binary);
+	if(file.fail()) {
+		cerr << "Error opening the checkpoint " << fileName << endl;
+		return false;
+	}
+	const CheckpointHeader header = {version, D, step, seed, proceduralConnections ? 1u : 0u,
+		{networkSize.excitatory, networkSize.inhibitory, networkSize.excitatoryConnections, networkSize.inhibitoryConnections}};
+	file.write(magic, sizeof(magic));
+	writeValue(file, header);
+	writePadding(file);
+	neurons.write(file);
+	connections.write(file);
+	return bool(file);
+}
+
+bool Network::readCheckpoint(const string& fileName, NetworkSize& size, unsigned int& s)
+{
+	ifstream file(fileName, ios::binary);
+	CheckpointHeader header;
+	if(file.fail() or !readHeader(file, header)) {
+		cerr << fileName << " is not a checkpoint" << endl;
+		return false;
+	}
+	size = NetworkSize{header.size[0], header.size[1], header.size[2], header.size[3]};
+	s = header.seed;
+	return true;
+}
+
+bool Network::restore(const string& fileName, unsigned long& step, bool mapConnections)
+{
+	ifstream file(fileName, ios::binary);
+	CheckpointHeader header;
+	if(file.fail() or !readHeader(file, header)) {
+		cerr << fileName << " is not a checkpoint" << endl;
+		return false;
+	}
+	if(header.seed != seed or header.size[0] != networkSize.excitatory or header.size[1] != networkSize.inhibitory
+	   or header.size[2] != networkSize.excitatoryConnections or header.size[3] != networkSize.inhibitoryConnections) {
+		cerr << "The checkpoint " << fileName << " is for another network" << endl;
+		return false;
+	}
+	if(!readPadding(file) or !neurons.read(file)) {
+		cerr << "Error reading the neurons of the checkpoint " << fileName << endl;
+		return false;
+	}
+
+	if(header.procedural != 0) {
+		instaureProceduralConnections();
+	} else {
+		const bool read(mapConnections ? connections.map(fileName, file.tellg()) : connections.read(file));
+		if(!read or connections.size() != networkSize.total()) {
+			cerr << "Error reading the connections of the checkpoint " << fileName << endl;
+			return false;
+		}
+		neurons.setConnectivity(connections);
+		proceduralConnections = false;
+	}
+	step = header.step;
+	return true;
 }
 
 Network::~Network()
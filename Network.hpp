@@ -3,15 +3,41 @@
 
 #include <iostream>
 #include "Neuron.hpp"
+#include "NeuronPopulation.hpp"
+#include "Connectivity.hpp"
+#include "ProceduralConnectivity.hpp"
+#include "NeuronGroup.hpp"
 #include <array>
 #include <random>
+#include <string>
+
+/*!
+ * @file Network.hpp
+ * size of a network: number of neurons and of connections received by each neuron of each type
+ */
+struct NetworkSize {
+	unsigned long excitatory; //!< number of excitatory neurons, the first ones of the network
+	unsigned long inhibitory; //!< number of inhibitory neurons
+	unsigned long excitatoryConnections; //!< number of connections a neuron receives from excitatory neurons
+	unsigned long inhibitoryConnections; //!< number of connections a neuron receives from inhibitory neurons
+
+	/*!
+	 * @return the total number of neurons
+     */
+	unsigned long total() const { return excitatory+inhibitory; }
+};
+
+const NetworkSize brunelSize = {excitatoryNeurons, inhibitoryNeurons, excitatoryConnections, inhibitoryConnections}; //!< network of the article, 12500 neurons
 
 /*!
  * @class Network
  * Class that is used to model the network of neurons in the brain.
- * We consider a network of 12500 neurons with 10000 excitatory and 2500 inhibitory.
+ * By default we consider a network of 12500 neurons with 10000 excitatory and 2500 inhibitory.
  * The connections are 1000 with excitatory neurons and 250 with inhibitory ones.
- * Each neuron has the same number of connections (1250).
+ * Each neuron has the same number of connections (1250). Other sizes can be chosen when the network is created,
+ * or other groups of neurons with the number of connections between each pair of groups.
+ * The neurons are stored in a NeuronPopulation, where each neuron is an index,
+ * and the connections in a Connectivity which gives the targets of each neuron.
  */
  
 class Network {
@@ -20,27 +46,122 @@ class Network {
 	
 	/*!
      * Constructor of the class Network
+     * @param seed: the seed used for the connections and the random spikes, a run is repeated with the same seed
+     */
+	Network(unsigned int seed = std::random_device()());
+
+	/*!
+     * Constructor of the class Network with a given size
+     * @param size: the number of neurons and of connections of each type
+     * @param seed: the seed used for the connections and the random spikes
+     */
+	Network(const NetworkSize& size, unsigned int seed = std::random_device()());
+
+	/*!
+     * Constructor of the class Network with other groups of neurons than the two of the article
+     * @param groups: the parameters of each group of neurons
+     * @param inDegrees: inDegrees[t][s] is the number of connections a neuron of the group t receives from the group s
+     * @param seed: the seed used for the connections and the random spikes
+     */
+	Network(const std::vector<NeuronGroup>& groups, const std::vector<std::vector<unsigned long> >& inDegrees,
+			unsigned int seed = std::random_device()());
+
+	/*!
+     * Getter of the size of the network
+     * @return size; 
+     */
+	const NetworkSize& getSize() const;
+
+	/*!
+     * Getter of the seed of the network
+     * @return seed; 
      */
-	Network();
+	unsigned int getSeed() const;
 	
 	/*!
-     * Getter of the vector neurons which contains all the neurons of the network
+     * Getter of the population which contains all the neurons of the network
+     * @return neurons; 
+     */
+	const NeuronPopulation& getPopulation() const;
+
+	/*!
+     * Getter of the population which contains all the neurons of the network, to update it
      * @return neurons; 
      */
-	std::array<Neuron*, totalN> getNeurons() const;
+	NeuronPopulation& getPopulation();
 
 	/*!
-     * Functions used to initialize the vector neurons.
-     * It creates two neurons, one excitatory and one inhibitory and it fills the array.
-     * It puts 10000 excitatory neurons and 2500 inhibitory neurons
+     * Getter of the connections between the neurons of the network
+     * @return connections; 
      */
-	void initializeNetwork();
+	const Connectivity& getConnectivity() const;
+
+	/*!
+     * Functions used to initialize the population of neurons.
+     * It asks the values of g and etha and gives them to the population.
+     * The population has 10000 excitatory neurons and 2500 inhibitory neurons
+     * @return false if they couldn't be read, the population is not changed
+     */
+	bool initializeNetwork();
+
+	/*!
+	 * @param g, etha: the parameters of the graph
+	 * Initializes the population of neurons with given values of g and etha, without asking them
+     */
+	void initializeNetwork(double g, double etha);
 	
 	/*!
 	 * Instaures the connections between the neurons randomly
-	 * 1000 with excitatory ones and 250 for inhibitory
+	 * 1000 with excitatory ones and 250 for inhibitory (or the numbers of the size of the network), or for each
+	 * group the number of connections given for its neurons, drawn in each group of sources one after the other
+	 * The sources of each neuron are drawn twice, to count the targets of each source and then to place them,
+	 * so only the targets are kept in memory
+	 * @param first, last: only the connections towards the neurons from first to last (excluded) are kept,
+	 * for a process which simulates these neurons; the connections kept are the same as in the whole network
+     */
+	void instaureConnections(unsigned long first = 0, unsigned long last = ~0ul);
+
+	/*!
+	 * Instaures procedural connections instead of stored ones: the targets of a neuron are drawn again
+	 * from the seed each time it spikes, each pair of neurons is connected with the probability which gives
+	 * 1000 excitatory and 250 inhibitory connections per neuron on average (or the numbers of the size). Nothing is stored for the connections.
+	 * They are only made for the two groups of the article.
+     */
+	void instaureProceduralConnections();
+
+	/*!
+	 * Getter of the procedural connections of the network
+	 * @return procedural; 
      */
-	void instaureConnections();
+	const ProceduralConnectivity& getProceduralConnectivity() const;
+
+	/*!
+	 * @param fileName: the name of the file to create; step: the next step to simulate
+	 * Writes a checkpoint of the whole network in a binary file: "BRCK", the version, the step, the seed, the size,
+	 * the state of all the neurons and the connections (only whether they are procedural if they are not stored).
+	 * The arrays start at multiples of 8 bytes, so the connections can be used in place by mapping the file.
+	 * Only the networks of the two groups of the article are saved, the file doesn't have the parameters of the groups
+	 * nor the weights of a plasticity.
+	 * @return false if the file can't be written
+     */
+	bool save(const std::string& fileName, unsigned long step) const;
+
+	/*!
+	 * @param fileName: the name of a checkpoint; size, seed: receive the size and the seed of the network
+	 * Reads the size and the seed of a checkpoint, to create a network which can restore it
+	 * @return false if the file is not a checkpoint
+     */
+	static bool readCheckpoint(const std::string& fileName, NetworkSize& size, unsigned int& seed);
+
+	/*!
+	 * @param fileName: the name of a checkpoint of a network of the same size
+	 * @param step: receives the next step to simulate
+	 * @param mapConnections: if true the connections are used in place in the file instead of being read
+	 * Restores the state of the neurons and the connections written by save, the simulation can continue
+	 * from step with exactly the same spikes as if it had not stopped
+	 * @return false if the file is not a checkpoint of this size or seed
+     */
+	bool restore(const std::string& fileName, unsigned long& step, bool mapConnections = true);
 	
 	/*!
      * destructor of the class Network
@@ -49,7 +170,18 @@ class Network {
 	
 	private:
 
-	std::array<Neuron*, totalN> neurons; //!< vector containing the neuron that compose the network (12500)
+	/*!
+	 * @return true if the network has the two groups of the article, with the same connections for both
+     */
+	bool hasBrunelGroups() const;
+
+	unsigned int seed; //!< seed of the random generators of the network
+	NetworkSize networkSize; //!< number of neurons and connections of the network, for the two groups of the article
+	std::vector<std::vector<unsigned long> > inDegrees; //!< connections received by a neuron of each group from each group
+	NeuronPopulation neurons; //!< population containing the neurons that compose the network
+	Connectivity connections; //!< targets of each neuron of the network
+	ProceduralConnectivity procedural; //!< connections drawn at each spike, if they are not stored
+	bool proceduralConnections; //!< true if the procedural connections are used
 
 };
 
@@ -7,8 +7,8 @@ using namespace std;
 
 Neuron::Neuron( double potential, unsigned int spike, int t, State st, vector<double> buffer,
 				int time, bool excit, std::vector<Neuron*> tg, bool spk)
-	:membranePotential(potential), spikes(spike), spikesOccured(t), state(st), ringBuffer(buffer),
-	 clock(time), excitatory(excit), targets(tg), spike(spk)
+	:g(0.0), etha(0.0), J_inhibitory(0.0), externalFrequency(0.0), membranePotential(potential), spikes(spike), spikesOccured(t), state(st), ringBuffer(buffer),
+	 clock(time), excitatory(excit), targets(tg), spike(spk), id(0)
 {}
 
 void Neuron::setG(double var)
@@ -21,6 +21,13 @@ void Neuron::setEtha(double e)
 {
 	etha = e;
 	externalFrequency = (etha/0.1)*h; //value given to the external frequency with etha
+	sampler = PoissonSampler(externalFrequency, sampler.getSeed());
+}
+
+void Neuron::setRandom(unsigned long i, unsigned int s)
+{
+	id = i;
+	sampler = PoissonSampler(externalFrequency, s);
 }
 	
 ////////////////GETTERS//////////////////////
@@ -60,7 +67,7 @@ double Neuron::getRingBuffer(int i) const
 	return ringBuffer[i];
 }
 
-vector<Neuron*> Neuron::getTargets() const
+const vector<Neuron*>& Neuron::getTargets() const
 {
 	return targets;
 }
@@ -119,11 +126,9 @@ void Neuron::setTargets(Neuron* n)
 double Neuron::externalSpikes()
 {
 	//creates a random value to add to the buffer which represents the number of spikes coming from the rest of the brains
-	static random_device rd;
-	static mt19937 generator(rd());
-	static poisson_distribution<int> distribution(externalFrequency); //Poisson distribution describes the random repartition
-	return (distribution(generator)*J_excitatory);  //we multiply it by the amplitude for the excitatory connections
-													//as each spike increases the membrane potential of J_excitatory
+	//Poisson distribution describes the random repartition, the number only depends on the seed, the neuron and the time
+	return (sampler.sample(id, clock)*J_excitatory);
+	//we multiply it by the amplitude for the excitatory connections as each spike increases the membrane potential of J_excitatory
 }
 
 void Neuron::updateState(int t)
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <array>
 #include <random>
+#include "PoissonSampler.hpp"
 
 constexpr int taurp(20); //!< constant of time of the repository period
 constexpr int tau(200); //!< constant of time 
@@ -39,7 +40,7 @@ constexpr unsigned long inhibitoryConnections(250); //!< number of inhibitory co
 /*! @file Neuron.hpp
  * states in which the neuron can be (refractory or inhibitory)
 */
-enum State {REFRACTORY, NON_REFRACTORY}; 
+enum State : unsigned char {REFRACTORY, NON_REFRACTORY}; 
 
 /*!
  * @class Neuron
@@ -78,6 +79,13 @@ class Neuron {
 	double J_inhibitory; //!< rate at which a neuron receives a random spike
 	double externalFrequency; //!< value of externalFrequency over thresold frequency 
 	
+	/*!
+	 * @param i: the index of the neuron in its network
+	 * @param s: the seed of the random spikes
+	 * Setter for the position of the random spikes of the neuron: they only depend on the seed, the index and the clock
+     */
+	void setRandom(unsigned long i, unsigned int s);
+	
 	/*!
 	 * @param var: a value for g
 	 * Setter for the value of g and J_inhibitory based on g
@@ -137,7 +145,7 @@ class Neuron {
 	 * Getter for the whole number of targets of the neuron
 	 * @return targets
      */
-	std::vector<Neuron*> getTargets() const;
+	const std::vector<Neuron*>& getTargets() const;
 	
 	bool getSpk() const;
 	
@@ -192,7 +200,8 @@ class Neuron {
 	void setTargets(Neuron* n); 
 	
 	/*!
-	 * Calculates randomly a number of spikes that the neuron receives from the rest of the brain
+	 * Calculates randomly a number of spikes that the neuron receives from the rest of the brain at the time of its clock,
+	 * a NeuronPopulation with the same seed gives the same spikes to the neuron with the same index
 	 * @return the number of random spikes times the value of the excitatory amplitude
      */
 	double externalSpikes();
@@ -251,6 +260,8 @@ class Neuron {
 	bool excitatory; //!< if false, the neuron is inhibitory
 	std::vector<Neuron*> targets; //!< vector containing all the targets of the neuron
 	bool spike; //!< boolean to know if the neuron has spiked
+	unsigned long id; //!< index of the neuron, stream of its random spikes
+	PoissonSampler sampler; //!< generator of the random spikes, based on externalFrequency and the seed
 
 };
 
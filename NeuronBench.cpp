@@ -0,0 +1,341 @@
+#include "Neuron.hpp"
+#include "Network.hpp"
+#include "NeuronPopulation.hpp"
+#include "Simulation.hpp"
+#include "NeuronRecorder.hpp"
+#include "Plasticity.hpp"
+#include "PoissonSampler.hpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/resource.h>
+
+using namespace std;
+
+constexpr unsigned int benchSeed(42); //!< the same network and the same spikes at each run of the benchmarks
+constexpr unsigned long benchSteps(1000); //!< steps of the benchmarks of the whole network (100 ms)
+
+namespace {
+
+	/*!
+	 * Results of a benchmark: its name, the best time of the repetitions and the rates per second
+     */
+	struct Result {
+		string name; //!< name of the benchmark
+		double seconds; //!< best time of the repetitions
+		vector<pair<string, double> > rates; //!< name and value of each rate, per second
+	};
+
+	vector<Result> results; //!< results of all the benchmarks, in order
+	unsigned int repetitions(3); //!< each benchmark is repeated, the best time is kept
+
+	/*!
+	 * @param name: the name of the benchmark; work: the code to measure
+	 * @param counts: the name of each rate and the number of operations made by one call of work
+	 * @param prepare: the code called before each repetition, which is not measured
+	 * Runs work several times and adds the best time and the rates to the results
+     */
+	void measure(const string& name, const function<void()>& work, const vector<pair<string, double> >& counts,
+				 const function<void()>& prepare = [] {})
+	{
+		double best(1e300);
+		for(unsigned int r(0); r < repetitions; ++r) {
+			prepare();
+			const auto start(chrono::steady_clock::now());
+			work();
+			best = min(best, chrono::duration<double>(chrono::steady_clock::now()-start).count());
+		}
+		Result result = {name, best, {}};
+		cout << name << ": " << best << " s";
+		for(auto const& count : counts) {
+			result.rates.push_back(make_pair(count.first, count.second/best));
+			cout << ", " << count.second/best << " " << count.first;
+		}
+		cout << endl;
+		results.push_back(result);
+	}
+
+	/*!
+	 * @return the largest memory used by the program until now, in kB
+     */
+	long peakMemory()
+	{
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return usage.ru_maxrss;
+	}
+
+	/*!
+	 * Builds a network of the article with the parameters of a graph
+     */
+	void buildNetwork(Network& net, double g, double etha)
+	{
+		net.initializeNetwork(g, etha);
+		net.instaureConnections();
+	}
+
+	/*!
+	 * @return the number of synaptic events of the spikes
+     */
+	double synapticEvents(const Connectivity& connections, const vector<vector<uint32_t> >& spikes)
+	{
+		double events(0.0);
+		for(auto const& step : spikes) {
+			for(auto i : step) {
+				events += connections.getNumberTargets(i);
+			}
+		}
+		return events;
+	}
+
+}
+
+int main(int argc, char* argv[])
+{
+	//"./Neuron_bench [output] [repetitions] [threads]": the results are also written in a file, one JSON object
+	//per line, which can be compared between two versions of the program
+	const string outputName(argc > 1 ? argv[1] : "bench.json");
+	if(argc > 2) {
+		repetitions = max(1, atoi(argv[2]));
+	}
+	const unsigned int threads(argc > 3 ? max(1, atoi(argv[3])) : 1);
+
+	//one neuron of the class Neuron, updated with the random spikes
+	measure("neuron_update", [] {
+		Neuron neuron;
+		neuron.setRandom(0, benchSeed);
+		neuron.setEtha(2.0);
+		for(unsigned long step(0); step < 1000000; ++step) {
+			neuron.update(step, 0.0, false, false);
+		}
+	}, {{"neuron_updates", 1e6}});
+
+	//one neuron of the class Neuron which spikes towards the connections of an inhibitory neuron of the article
+	vector<Neuron> targets(excitatoryConnections+inhibitoryConnections);
+	Neuron source(0.0, 1);
+	for(auto& target : targets) {
+		source.setTargets(&target);
+	}
+	measure("neuron_fill_ring_buffer", [&] {
+		for(unsigned long step(0); step < 10000; ++step) {
+			source.fillRingBufferOfTargets(step);
+		}
+	}, {{"synaptic_events", 10000.0*targets.size()}});
+
+	//random spikes of the rest of the brain, for a neuron of the class Neuron, one neuron of a population
+	//at a time and a whole block at a time
+	double sum(0.0);
+	measure("neuron_external_spikes", [&] {
+		Neuron neuron;
+		neuron.setRandom(0, benchSeed);
+		neuron.setEtha(2.0);
+		for(unsigned long step(0); step < 1000000; ++step) {
+			sum += neuron.externalSpikes();
+		}
+	}, {{"samples", 1e6}});
+	NeuronPopulation population(totalN, excitatoryNeurons, benchSeed);
+	population.setEtha(2.0);
+	measure("external_spikes", [&] {
+		for(unsigned long step(0); step < 100; ++step) {
+			for(unsigned long i(0); i < totalN; ++i) {
+				sum += population.externalSpikes(i, step);
+			}
+		}
+	}, {{"samples", 100.0*totalN}});
+	PoissonSampler sampler(2.0, benchSeed);
+	vector<double> noise(totalN);
+	measure("external_spikes_block", [&] {
+		for(unsigned long step(0); step < 1000; ++step) {
+			sampler.fill(noise.data(), 0, totalN, step, J_excitatory);
+			sum += noise[step];
+		}
+	}, {{"samples", 1000.0*totalN}});
+
+	//connections of the network of the article
+	measure("instaure_connections", [] {
+		Network net(benchSeed);
+		net.instaureConnections();
+	}, {{"connections", double(totalN)*(excitatoryConnections+inhibitoryConnections)}});
+
+	//the spikes of the graph (c) are recorded, then given again to the delivery
+	Network net(benchSeed);
+	buildNetwork(net, 5.0, 2.0);
+	vector<vector<uint32_t> > spikes;
+	Simulation(net.getPopulation(), 1).run(0, benchSteps, 0.0, [&](unsigned long, const vector<uint32_t>& s) { spikes.push_back(s); });
+	const double events(synapticEvents(net.getConnectivity(), spikes));
+	NeuronPopulation& neurons(net.getPopulation());
+	measure("fill_ring_buffer", [&] {
+		for(size_t k(0); k < spikes.size(); ++k) {
+			for(auto i : spikes[k]) {
+				neurons.fillRingBufferOfTargets(i, k);
+			}
+		}
+	}, {{"synaptic_events", events}});
+	measure("deliver_spikes", [&] {
+		for(size_t k(0); k < spikes.size(); ++k) {
+			neurons.deliverSpikes(k, spikes[k], 0, totalN);
+		}
+	}, {{"synaptic_events", events}});
+	//the same delivery into the counts of spikes of each group, emptied before each repetition
+	measure("deliver_spikes_counts", [&] {
+		for(size_t k(0); k < spikes.size(); ++k) {
+			neurons.deliverSpikes(k, spikes[k], 0, totalN);
+		}
+	}, {{"synaptic_events", events}}, [&] { neurons.setRingBufferType(COUNT_RING_BUFFER); });
+	neurons.setRingBufferType(AMPLITUDE_RING_BUFFER);
+
+	//update of all the neurons of the population without the delivery of the spikes
+	vector<vector<uint32_t> > window(D);
+	measure("population_update", [&] {
+		for(unsigned long step(0); step < benchSteps; step += D) {
+			for(auto& list : window) {
+				list.clear();
+			}
+			neurons.update(step, 0.0, 0, totalN, window);
+		}
+	}, {{"neuron_updates", double(benchSteps)*totalN}});
+
+	//the same delivery with the weights of the excitatory synapses, which change at each spike, from new weights
+	//at each repetition
+	unique_ptr<Plasticity> plasticity;
+	measure("deliver_spikes_stdp", [&] {
+		for(size_t k(0); k < spikes.size(); ++k) {
+			neurons.deliverSpikes(k, spikes[k], 0, totalN);
+		}
+	}, {{"synaptic_events", events}}, [&] {
+		plasticity.reset(new Plasticity(net.getConnectivity(), neurons.getGroups()));
+		neurons.setPlasticity(*plasticity);
+	});
+
+	//whole simulation of the four graphs of ReadMe.txt, from a new network at each repetition
+	const vector<pair<string, pair<double, double> > > graphs = {{"network_a", {3.0, 2.0}}, {"network_b", {6.0, 4.0}},
+																 {"network_c", {5.0, 2.0}}, {"network_d", {4.5, 0.9}}};
+	for(auto const& graph : graphs) {
+		double graphEvents(0.0);
+		unique_ptr<Network> network;
+		measure(graph.first, [&] {
+			const Connectivity& connections(network->getConnectivity());
+			Simulation(network->getPopulation(), threads).run(0, benchSteps, 0.0, [&](unsigned long, const vector<uint32_t>& s) {
+				for(auto i : s) {
+					graphEvents += connections.getNumberTargets(i);
+				}
+			});
+		}, {{"steps", double(benchSteps)}, {"neuron_updates", double(benchSteps)*totalN}}, [&] {
+			network.reset();
+			network.reset(new Network(benchSeed));
+			buildNetwork(*network, graph.second.first, graph.second.second);
+			graphEvents = 0.0;
+		});
+		//the spikes are the same at each repetition, so are the events
+		results.back().rates.push_back(make_pair("synaptic_events", graphEvents/results.back().seconds));
+	}
+
+	//the same simulations with the membrane potentials and the ring buffers in single precision
+	for(auto const& graph : graphs) {
+		unique_ptr<Network> network;
+		unique_ptr<FloatNeuronPopulation> single;
+		measure(graph.first + "_float", [&] {
+			FloatSimulation(*single, threads).run(0, benchSteps, 0.0, [](unsigned long, const vector<uint32_t>&) {});
+		}, {{"steps", double(benchSteps)}, {"neuron_updates", double(benchSteps)*totalN}}, [&] {
+			single.reset();
+			network.reset(new Network(benchSeed));
+			buildNetwork(*network, graph.second.first, graph.second.second);
+			single.reset(new FloatNeuronPopulation(totalN, excitatoryNeurons, benchSeed));
+			single->setG(graph.second.first);
+			single->setEtha(graph.second.second);
+			single->setConnectivity(network->getConnectivity());
+		});
+	}
+
+	//the same simulations with the counts of spikes of each group in the ring buffers
+	for(auto const& graph : graphs) {
+		unique_ptr<Network> network;
+		measure(graph.first + "_counts", [&] {
+			Simulation(network->getPopulation(), threads).run(0, benchSteps, 0.0, [](unsigned long, const vector<uint32_t>&) {});
+		}, {{"steps", double(benchSteps)}, {"neuron_updates", double(benchSteps)*totalN}}, [&] {
+			network.reset();
+			network.reset(new Network(benchSeed));
+			buildNetwork(*network, graph.second.first, graph.second.second);
+			network->getPopulation().setRingBufferType(COUNT_RING_BUFFER);
+		});
+	}
+
+	//the same simulations with the random spikes drawn only for the active neurons
+	for(auto const& graph : graphs) {
+		unique_ptr<Network> network;
+		measure(graph.first + "_active", [&] {
+			Simulation(network->getPopulation(), threads).run(0, benchSteps, 0.0, [](unsigned long, const vector<uint32_t>&) {});
+		}, {{"steps", double(benchSteps)}, {"neuron_updates", double(benchSteps)*totalN}}, [&] {
+			network.reset();
+			network.reset(new Network(benchSeed));
+			buildNetwork(*network, graph.second.first, graph.second.second);
+			network->getPopulation().setScheduling(ACTIVE_NEURONS_SCHEDULING);
+		});
+	}
+
+	//the graph (c) with the recorders of pythonScript.py: the spikes and the potentials of 30 neurons for 50 ms
+	{
+		unique_ptr<Network> network;
+		unique_ptr<NeuronRecorder> spikeRecorder, potentialRecorder;
+		measure("network_c_recorders", [&] {
+			Simulation(network->getPopulation(), threads).run(0, benchSteps, 0.0, Simulation::Recorder());
+		}, {{"steps", double(benchSteps)}, {"neuron_updates", double(benchSteps)*totalN}}, [&] {
+			network.reset();
+			network.reset(new Network(benchSeed));
+			buildNetwork(*network, 5.0, 2.0);
+			spikeRecorder.reset(new NeuronRecorder(SPIKE_RECORDING, 0, 30, benchSteps/2, benchSteps));
+			potentialRecorder.reset(new NeuronRecorder(POTENTIAL_RECORDING, 0, 30, benchSteps/2, benchSteps));
+			network->getPopulation().addRecorder(*spikeRecorder);
+			network->getPopulation().addRecorder(*potentialRecorder);
+		});
+	}
+
+	//the graph (c) with the plasticity of the excitatory synapses, against network_c with static synapses
+	{
+		double stdpEvents(0.0);
+		unique_ptr<Network> network;
+		unique_ptr<Plasticity> synapses;
+		measure("network_c_stdp", [&] {
+			const Connectivity& connections(network->getConnectivity());
+			Simulation(network->getPopulation(), threads).run(0, benchSteps, 0.0, [&](unsigned long, const vector<uint32_t>& s) {
+				for(auto i : s) {
+					stdpEvents += connections.getNumberTargets(i);
+				}
+			});
+		}, {{"steps", double(benchSteps)}, {"neuron_updates", double(benchSteps)*totalN}}, [&] {
+			synapses.reset();
+			network.reset();
+			network.reset(new Network(benchSeed));
+			buildNetwork(*network, 5.0, 2.0);
+			synapses.reset(new Plasticity(network->getConnectivity(), network->getPopulation().getGroups()));
+			network->getPopulation().setPlasticity(*synapses);
+			stdpEvents = 0.0;
+		});
+		results.back().rates.push_back(make_pair("synaptic_events", stdpEvents/results.back().seconds));
+	}
+
+	const long peak(peakMemory());
+	cout << "peak RSS: " << peak << " kB" << endl;
+
+	ofstream output(outputName);
+	if(output.fail()) {
+		cerr << "Error opening the file of the results " << outputName << endl;
+		return 1;
+	}
+	for(auto const& result : results) {
+		output << "{\"benchmark\": \"" << result.name << "\", \"seconds\": " << result.seconds;
+		for(auto const& rate : result.rates) {
+			output << ", \"" << rate.first << "_per_second\": " << rate.second;
+		}
+		output << "}\n";
+	}
+	output << "{\"benchmark\": \"memory\", \"peak_rss_kb\": " << peak << ", \"threads\": " << threads
+		   << ", \"repetitions\": " << repetitions << ", \"checksum\": " << sum << "}\n";
+	return 0;
+}
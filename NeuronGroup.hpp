@@ -0,0 +1,35 @@
+#ifndef NEURONGROUP_HPP
+#define NEURONGROUP_HPP
+
+#include <iostream>
+#include <vector>
+#include "Neuron.hpp"
+
+/*!
+ * @file NeuronGroup.hpp
+ * @struct NeuronGroup
+ * Parameters shared by a group of neurons of a population, stored once for the group instead of once per neuron.
+ * The groups follow each other in the population: the first group has the first size neurons, and so on.
+ * The amplitude of the spikes and the rate of the random spikes are relative to the parameters of the graph,
+ * so setG and setEtha of the population still change all the groups: an excitatory group (weight > 0) gives
+ * weight*J_excitatory to its targets, an inhibitory group -weight*g*J_excitatory, and a group receives random
+ * spikes at drive times the rate given by etha. The delay is D for all the groups, the epochs of the simulation last D steps.
+ */
+struct NeuronGroup {
+	unsigned long size; //!< number of neurons of the group
+	double weight; //!< amplitude of its spikes in units of J_excitatory, times g if it is negative
+	double drive; //!< rate of its random spikes in units of the rate given by etha
+	double threshold; //!< membrane potential at which its neurons spike (mV)
+	int refractory; //!< steps of the refractory period of its neurons
+};
+
+/*!
+ * @param excitatory, inhibitory: the number of neurons of each type
+ * @return the two groups of the article: the excitatory neurons, then the inhibitory ones
+ */
+inline std::vector<NeuronGroup> brunelGroups(unsigned long excitatory, unsigned long inhibitory)
+{
+	return {{excitatory, 1.0, 1.0, theta, taurp}, {inhibitory, -1.0, 1.0, theta, taurp}};
+}
+
+#endif
@@ -0,0 +1,569 @@
+#include "NeuronPopulation.hpp"
+#include <iostream>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include "BinaryIO.hpp"
+#include "Instrumentation.hpp"
+
+using namespace std;
+
+template<typename Real>
+BasicNeuronPopulation<Real>::BasicNeuronPopulation(unsigned long size, unsigned long excitatory, unsigned int seed)
+	:BasicNeuronPopulation(brunelGroups(excitatory, size-excitatory), seed)
+{
+	assert(excitatory <= size);
+}
+
+template<typename Real>
+BasicNeuronPopulation<Real>::BasicNeuronPopulation(const vector<NeuronGroup>& neuronGroups, unsigned int seed)
+	:numberNeurons(0), groups(neuronGroups), g(0.0), etha(0.0), J_inhibitory(0.0), externalFrequency(0.0),
+	 ringBufferType(AMPLITUDE_RING_BUFFER), scheduling(ALL_NEURONS_SCHEDULING), connections(nullptr), procedural(nullptr),
+	 plasticity(nullptr), kernel(UpdateKernel::best())
+{
+	assert(!groups.empty() and groups.size() <= 256); //the index of a group is one byte
+	for(size_t k(0); k < groups.size(); ++k) {
+		numberNeurons += groups[k].size;
+		groupEnd.push_back(numberNeurons);
+		group.insert(group.end(), groups[k].size, k);
+	}
+	membranePotential.assign(numberNeurons, 0.0);
+	spikes.assign(numberNeurons, 0);
+	spikesOccured.assign(numberNeurons, 0);
+	state.assign(numberNeurons, NON_REFRACTORY);
+	clock.assign(numberNeurons, 0);
+	ringBuffer.assign((D+1)*numberNeurons, 0.0);
+	samplers.assign(groups.size(), PoissonSampler(0.0, seed));
+	setG(0.0);
+	selectUpdate();
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setG(double var)
+{
+	g = var;
+	J_inhibitory = -g*J_excitatory; //we give a value to the inhibitory amplitude
+	amplitude.resize(groups.size());
+	for(size_t k(0); k < groups.size(); ++k) { //the inhibitory groups follow g
+		amplitude[k] = (groups[k].weight > 0.0) ? groups[k].weight*J_excitatory : groups[k].weight*g*J_excitatory;
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setEtha(double e)
+{
+	etha = e;
+	externalFrequency = (etha/0.1)*h; //value given to the external frequency with etha
+	for(size_t k(0); k < groups.size(); ++k) { //the tables follow the new frequency
+		samplers[k] = PoissonSampler(externalFrequency*groups[k].drive, samplers[k].getSeed());
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setSeed(unsigned int seed)
+{
+	for(size_t k(0); k < groups.size(); ++k) {
+		samplers[k] = PoissonSampler(externalFrequency*groups[k].drive, seed);
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setKernel(KernelType type)
+{
+	kernel = UpdateKernel(type);
+	selectUpdate();
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setRingBufferType(RingBufferType type)
+{
+	assert(plasticity == nullptr or type == AMPLITUDE_RING_BUFFER); //the weights are not counted
+	ringBufferType = type;
+	//only the buffers of this type are allocated
+	if(type == COUNT_RING_BUFFER) {
+		vector<Real>().swap(ringBuffer);
+		spikeCounts.assign((D+1)*groups.size()*numberNeurons, 0);
+	} else {
+		vector<SpikeCount>().swap(spikeCounts);
+		ringBuffer.assign((D+1)*numberNeurons, 0.0);
+	}
+	selectUpdate();
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setScheduling(SchedulingType type)
+{
+	scheduling = type;
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::selectUpdate()
+{
+	const bool counts(ringBufferType == COUNT_RING_BUFFER);
+	switch(kernel.getType()) {
+		case AVX512_KERNEL:
+			updater = counts ? &BasicNeuronPopulation::updateBlocks<COUNT_RING_BUFFER, AVX512_KERNEL>
+							 : &BasicNeuronPopulation::updateBlocks<AMPLITUDE_RING_BUFFER, AVX512_KERNEL>;
+			break;
+		case AVX2_KERNEL:
+			updater = counts ? &BasicNeuronPopulation::updateBlocks<COUNT_RING_BUFFER, AVX2_KERNEL>
+							 : &BasicNeuronPopulation::updateBlocks<AMPLITUDE_RING_BUFFER, AVX2_KERNEL>;
+			break;
+		default:
+			updater = counts ? &BasicNeuronPopulation::updateBlocks<COUNT_RING_BUFFER, SCALAR_KERNEL>
+							 : &BasicNeuronPopulation::updateBlocks<AMPLITUDE_RING_BUFFER, SCALAR_KERNEL>;
+	}
+}
+
+////////////////GETTERS//////////////////////
+
+template<typename Real>
+unsigned long BasicNeuronPopulation<Real>::size() const
+{
+	return numberNeurons;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getG() const
+{
+	return g;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getEtha() const
+{
+	return etha;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getJInhibitory() const
+{
+	return J_inhibitory;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getExternalFrequency() const
+{
+	return externalFrequency;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getMembranePotential(unsigned long i) const
+{
+	return membranePotential[i];
+}
+
+template<typename Real>
+unsigned int BasicNeuronPopulation<Real>::getSpikes(unsigned long i) const
+{
+	return spikes[i];
+}
+
+template<typename Real>
+int BasicNeuronPopulation<Real>::getSpikesOccured(unsigned long i) const
+{
+	return spikesOccured[i];
+}
+
+template<typename Real>
+State BasicNeuronPopulation<Real>::getState(unsigned long i) const
+{
+	return state[i];
+}
+
+template<typename Real>
+int BasicNeuronPopulation<Real>::getClock(unsigned long i) const
+{
+	return clock[i];
+}
+
+template<typename Real>
+bool BasicNeuronPopulation<Real>::getExcitatory(unsigned long i) const
+{
+	return groups[group[i]].weight > 0.0;
+}
+
+template<typename Real>
+unsigned int BasicNeuronPopulation<Real>::getGroup(unsigned long i) const
+{
+	return group[i];
+}
+
+template<typename Real>
+const vector<NeuronGroup>& BasicNeuronPopulation<Real>::getGroups() const
+{
+	return groups;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getAmplitude(unsigned int k) const
+{
+	return amplitude[k];
+}
+
+template<typename Real>
+RingBufferType BasicNeuronPopulation<Real>::getRingBufferType() const
+{
+	return ringBufferType;
+}
+
+template<typename Real>
+SchedulingType BasicNeuronPopulation<Real>::getScheduling() const
+{
+	return scheduling;
+}
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::getRingBuffer(unsigned long i, unsigned int index) const
+{
+	assert(index < D+1);
+	if(ringBufferType == COUNT_RING_BUFFER) { //the amplitude the update will read
+		Real J(0.0);
+		for(size_t k(0); k < groups.size(); ++k) {
+			J += Real(spikeCounts[(index*groups.size() + k)*numberNeurons + i])*Real(amplitude[k]);
+		}
+		return J;
+	}
+	return ringBuffer[index*numberNeurons + i];
+}
+
+template<typename Real>
+const Plasticity* BasicNeuronPopulation<Real>::getPlasticity() const
+{
+	return plasticity;
+}
+
+template<typename Real>
+const vector<uint32_t>& BasicNeuronPopulation<Real>::getSpiking() const
+{
+	return spiking;
+}
+
+template<typename Real>
+Neuron BasicNeuronPopulation<Real>::getNeuron(unsigned long i) const
+{
+	vector<double> buffer(D+1, 0.0);
+	for(size_t t(0); t < buffer.size(); ++t) {
+		buffer[t] = getRingBuffer(i, t);
+	}
+	Neuron neuron(membranePotential[i], spikes[i], spikesOccured[i], state[i], buffer, clock[i], getExcitatory(i));
+	neuron.setG(g);
+	neuron.setEtha(etha*groups[group[i]].drive);
+	neuron.setRandom(i, samplers[0].getSeed()); //the neuron receives the same random spikes
+	return neuron;
+}
+
+//////////////////SETTERS////////////////////////
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setMembranePotential(unsigned long i, double potential)
+{
+	membranePotential[i] = potential;
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setRingBuffer(unsigned long i, unsigned int index, double J)
+{
+	//increases the ring buffer of the neuron i at index "index" of J
+	assert(index < D+1 and ringBufferType == AMPLITUDE_RING_BUFFER);
+	ringBuffer[index*numberNeurons + i] += J;
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setConnectivity(const Connectivity& connectivity)
+{
+	assert(connectivity.size() == numberNeurons);
+	connections = &connectivity;
+	procedural = nullptr;
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setConnectivity(const ProceduralConnectivity& connectivity)
+{
+	assert(connectivity.size() == numberNeurons);
+	assert(plasticity == nullptr); //the weights are stored with the connections
+	procedural = &connectivity;
+	connections = nullptr;
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::addRecorder(NeuronRecorder& recorder)
+{
+	recorders.push_back(&recorder);
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setPlasticity(Plasticity& synapses)
+{
+	assert(connections != nullptr and ringBufferType == AMPLITUDE_RING_BUFFER);
+	plasticity = &synapses;
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::setPartition(const vector<unsigned long>& bounds)
+{
+	if(plasticity != nullptr) {
+		plasticity->setPartition(bounds);
+	}
+}
+
+/////////////////////////OTHER FUNCTIONS///////////////////////
+
+template<typename Real>
+double BasicNeuronPopulation<Real>::externalSpikes(unsigned long i, unsigned long step) const
+{
+	//random number of spikes coming from the rest of the brain, times the excitatory amplitude
+	return (samplers[group[i]].sample(i, step)*J_excitatory);
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::update(unsigned long step, double I)
+{
+	spiking.clear();
+	update(step, I, 0, numberNeurons, spiking);
+	recordSpikes(step, spiking);
+
+	//the spikes are written in the slot which is read D steps later, it's never the slot read during this step
+	deliverSpikes(step, spiking, 0, numberNeurons);
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::update(unsigned long step, double I, unsigned long first, unsigned long last, vector<uint32_t>& spikingNeurons)
+{
+	(this->*updater)(step, I, first, last, spikingNeurons);
+}
+
+template<typename Real>
+template<RingBufferType buffers, KernelType type>
+void BasicNeuronPopulation<Real>::updateBlocks(unsigned long step, double I, unsigned long first, unsigned long last,
+											   vector<uint32_t>& spikingNeurons)
+{
+	assert(first%blockSize == 0 and last <= numberNeurons);
+	const unsigned int t = step%(D+1);
+	const bool counts(buffers == COUNT_RING_BUFFER);
+	Real* const input = counts ? nullptr : &ringBuffer[t*numberNeurons]; //inputs of all the neurons for this time
+	Real noise[blockSize]; //random spikes received by the neurons of the block
+	uint8_t integrates[blockSize]; //1 for the neurons of the block which integrate
+	uint16_t active[blockSize]; //positions in the block of the neurons which integrate
+	Real counted[blockSize]; //inputs of the block computed from the counts
+
+	for(unsigned long b(first), end(first); b < last; b = end) {
+		const unsigned int k(group[b]);
+		end = min(min(b-b%blockSize+blockSize, last), groupEnd[k]); //a block stops at the end of its group
+
+		{
+			BRUNEL_TIME(NOISE_PHASE);
+			if(scheduling == ACTIVE_NEURONS_SCHEDULING) { //only the neurons which integrate get random spikes
+				const Real threshold(groups[k].threshold);
+				const int refractory(groups[k].refractory);
+				for(unsigned long j(b); j < end; ++j) { //the same conditions as the kernel, in a loop without branch
+					const int spikeTime(spikesOccured[j]);
+					const int time(clock[j]);
+					const bool waits((spikeTime <= time) & (time < spikeTime+refractory) & (spikeTime != 0));
+					integrates[j-b] = !waits & (membranePotential[j] < threshold);
+				}
+				unsigned long number(0);
+				for(unsigned long j(0); j < end-b; ++j) { //the list of the neurons which integrate
+					active[number] = j;
+					number += integrates[j];
+				}
+				fill(noise, noise+(end-b), Real(0.0)); //the other neurons don't use their random spikes
+				samplers[k].fill(noise, b, end-b, step, J_excitatory, active, number);
+			} else {
+				samplers[k].fill(noise, b, end-b, step, J_excitatory); //random spikes of the whole block
+			}
+		}
+
+		if(counts) { //the counts of each group times its amplitude, the counts are emptied for the next round
+			fill(counted, counted+(end-b), Real(0.0));
+			for(size_t s(0); s < groups.size(); ++s) {
+				SpikeCount* const count(&spikeCounts[(t*groups.size() + s)*numberNeurons]);
+				const Real J(amplitude[s]);
+				for(unsigned long j(b); j < end; ++j) {
+					counted[j-b] += Real(count[j])*J;
+				}
+				fill(count+b, count+end, SpikeCount(0));
+			}
+		}
+
+		const BasicNeuronBlock<Real> block = {b, end-b, &membranePotential[b], &spikesOccured[b], &clock[b], &state[b],
+								   &spikes[b], counts ? counted : &input[b], noise, Real(groups[k].threshold), groups[k].refractory};
+		{
+			BRUNEL_TIME(MEMBRANE_PHASE);
+			UpdateKernel::update<type>(block, Real(I*c2), spikingNeurons);
+		}
+#ifdef BRUNEL_INSTRUMENTATION
+		//after the update the neurons which spiked are refractory too, the others didn't integrate their inputs
+		const size_t blockSpikes(spikingNeurons.end()-lower_bound(spikingNeurons.begin(), spikingNeurons.end(), b));
+		BRUNEL_COUNT(REFRACTORY_COUNTER, count(block.state, block.state+block.size, REFRACTORY) - blockSpikes);
+#endif
+		for(auto recorder : recorders) { //each thread writes the neurons of its blocks
+			recorder->recordPotentials(step, b, end, block.membranePotential);
+		}
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::update(unsigned long step, double I, unsigned long first, unsigned long last,
+							  vector<vector<uint32_t> >& spikingNeurons)
+{
+	assert(spikingNeurons.size() <= D);
+	for(unsigned long b(first); b < last; b += blockSize) { //block after block
+		const unsigned long end(min(b+blockSize, last));
+		for(size_t k(0); k < spikingNeurons.size(); ++k) { //all the steps of the window for this block
+			update(step+k, I, b, end, spikingNeurons[k]);
+		}
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::fillRingBufferOfTargets(unsigned long i, unsigned long step)
+{
+	fillRingBufferOfTargets(i, step, 0, numberNeurons);
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::fillRingBufferOfTargets(unsigned long i, unsigned long step, unsigned long first, unsigned long last)
+{
+	const unsigned int readOut = (step+D)%(D+1);
+	if(plasticity != nullptr) { //the weight of each synapse
+		deliverSpikes(step, vector<uint32_t>(1, i), first, last);
+	} else if(ringBufferType == COUNT_RING_BUFFER) { //one more spike of its group for each target
+		addToTargets(i, &spikeCounts[(readOut*groups.size() + group[i])*numberNeurons], SpikeCount(1), first, last);
+	} else { //same amplitude for all the targets
+		addToTargets(i, &ringBuffer[readOut*numberNeurons], Real(amplitude[group[i]]), first, last);
+	}
+}
+
+template<typename Real>
+template<typename Value>
+void BasicNeuronPopulation<Real>::addToTargets(unsigned long i, Value* buffer, Value value, unsigned long first, unsigned long last)
+{
+	if(procedural != nullptr) { //only the blocks of the range are drawn
+		uint64_t events(0);
+		procedural->forEachTarget(i, first, last, [buffer, value, &events](uint32_t target) { buffer[target] += value; ++events; });
+		BRUNEL_COUNT(EVENTS_COUNTER, events);
+		return;
+	}
+	assert(connections != nullptr);
+	//the targets are sorted, so the ones of the range are contiguous
+	const uint32_t* target(lower_bound(connections->beginTargets(i), connections->endTargets(i), first));
+	const uint32_t* const end(lower_bound(target, connections->endTargets(i), last));
+	BRUNEL_COUNT(EVENTS_COUNTER, end-target);
+	for(; target != end; ++target) {
+		assert(*target < numberNeurons);
+		buffer[*target] += value;
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::deliverSpikes(unsigned long step, const vector<uint32_t>& sources, unsigned long first, unsigned long last)
+{
+	if(plasticity != nullptr) { //the weights are read with the targets of each source, the traces follow the steps
+		const unsigned int readOut = (step+D)%(D+1);
+		const uint64_t events(plasticity->deliver(step, sources, first, last, &ringBuffer[readOut*numberNeurons], group, amplitude));
+		BRUNEL_COUNT(EVENTS_COUNTER, events);
+		return;
+	}
+	if(procedural != nullptr or sources.size() < 2) { //the procedural targets are already drawn block by block
+		for(auto i : sources) {
+			fillRingBufferOfTargets(i, step, first, last);
+		}
+		return;
+	}
+	const unsigned int readOut = (step+D)%(D+1);
+
+	//next target of each source in the range, and the end of its targets in the range
+	assert(connections != nullptr);
+	vector<const uint32_t*> next(sources.size()), end(sources.size());
+	uint64_t events(0);
+	for(size_t s(0); s < sources.size(); ++s) {
+		next[s] = lower_bound(connections->beginTargets(sources[s]), connections->endTargets(sources[s]), first);
+		end[s] = lower_bound(next[s], connections->endTargets(sources[s]), last);
+		events += end[s]-next[s];
+	}
+	BRUNEL_COUNT(EVENTS_COUNTER, events);
+
+	if(ringBufferType == COUNT_RING_BUFFER) { //each source counts in the slot of its group
+		vector<SpikeCount*> buffers(sources.size());
+		for(size_t s(0); s < sources.size(); ++s) {
+			buffers[s] = &spikeCounts[(readOut*groups.size() + group[sources[s]])*numberNeurons];
+		}
+		deliverTiles(buffers, vector<SpikeCount>(sources.size(), 1), next, end, first, last);
+	} else {
+		vector<Real> J(sources.size());
+		for(size_t s(0); s < sources.size(); ++s) {
+			J[s] = amplitude[group[sources[s]]];
+		}
+		deliverTiles(vector<Real*>(sources.size(), &ringBuffer[readOut*numberNeurons]), J, next, end, first, last);
+	}
+}
+
+template<typename Real>
+template<typename Value>
+void BasicNeuronPopulation<Real>::deliverTiles(const vector<Value*>& buffers, const vector<Value>& values, vector<const uint32_t*>& next,
+											   const vector<const uint32_t*>& end, unsigned long first, unsigned long last)
+{
+	for(unsigned long tile(first); tile < last; tile += deliveryTile) {
+		const unsigned long tileEnd(min(tile+deliveryTile, last));
+		for(size_t s(0); s < next.size(); ++s) { //in increasing order of the source, as for a single spike
+			Value* const buffer(buffers[s]);
+			const Value value(values[s]);
+			const uint32_t* target(next[s]);
+			for(; target != end[s] and *target < tileEnd; ++target) {
+				buffer[*target] += value;
+			}
+			next[s] = target;
+		}
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::recordSpikes(unsigned long step, const vector<uint32_t>& spikes)
+{
+	for(auto recorder : recorders) {
+		recorder->recordSpikes(step, spikes);
+	}
+}
+
+template<typename Real>
+void BasicNeuronPopulation<Real>::write(ostream& out) const
+{
+	assert(ringBufferType == AMPLITUDE_RING_BUFFER); //the checkpoints have the ring buffers of amplitudes
+	const uint64_t sizes[2] = {numberNeurons, groups[0].size}; //the excitatory neurons in the network of the article
+	const uint64_t seed(samplers[0].getSeed());
+	writeValue(out, sizes);
+	writeValue(out, g);
+	writeValue(out, etha);
+	writeValue(out, seed);
+	writeArray(out, membranePotential);
+	writeArray(out, spikes);
+	writeArray(out, spikesOccured);
+	writeArray(out, state);
+	writeArray(out, clock);
+	writeArray(out, ringBuffer);
+}
+
+template<typename Real>
+bool BasicNeuronPopulation<Real>::read(istream& in)
+{
+	assert(ringBufferType == AMPLITUDE_RING_BUFFER); //the checkpoints have the ring buffers of amplitudes
+	uint64_t sizes[2] = {0, 0};
+	uint64_t seed(0);
+	double gRead(0.0), ethaRead(0.0);
+	if(!readValue(in, sizes) or !readValue(in, gRead) or !readValue(in, ethaRead) or !readValue(in, seed)) {
+		return false;
+	}
+	if(sizes[0] != numberNeurons or sizes[1] != groups[0].size) {
+		cerr << "The state is for " << sizes[0] << " neurons instead of " << numberNeurons << endl;
+		return false;
+	}
+	setG(gRead);
+	setSeed(seed);
+	setEtha(ethaRead);
+	return readArray(in, membranePotential) and readArray(in, spikes) and readArray(in, spikesOccured)
+		   and readArray(in, state) and readArray(in, clock) and readArray(in, ringBuffer);
+}
+
+template class BasicNeuronPopulation<double>;
+template class BasicNeuronPopulation<float>;
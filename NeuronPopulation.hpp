@@ -0,0 +1,459 @@
+#ifndef NEURONPOPULATION_HPP
+#define NEURONPOPULATION_HPP
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include "Neuron.hpp"
+#include "PoissonSampler.hpp"
+#include "Connectivity.hpp"
+#include "ProceduralConnectivity.hpp"
+#include "UpdateKernel.hpp"
+#include "NeuronGroup.hpp"
+#include "NeuronRecorder.hpp"
+#include "Plasticity.hpp"
+
+constexpr unsigned long blockSize(256); //!< number of neurons updated together by the kernel, threads always update whole blocks
+constexpr unsigned long deliveryTile(2048); //!< number of neurons whose inputs are filled together by the spikes of a step
+static_assert(blockSize%targetBlockSize == 0, "the range of a thread must start a block of procedural targets");
+
+typedef uint16_t SpikeCount; //!< number of spikes of a group received by a neuron for a step
+
+/*!
+ * contents of the ring buffers: the sum of the amplitudes received by each neuron, or the number of spikes
+ * received from each group
+ */
+enum RingBufferType {AMPLITUDE_RING_BUFFER, COUNT_RING_BUFFER};
+
+/*!
+ * neurons which receive random spikes at a step: all the neurons of a block, or only the active ones, which are
+ * neither refractory nor above the threshold
+ */
+enum SchedulingType {ALL_NEURONS_SCHEDULING, ACTIVE_NEURONS_SCHEDULING};
+
+/*!
+ * @class BasicNeuronPopulation
+ * Class that stores all the neurons of the network as a structure of arrays.
+ * Instead of one heap allocated Neuron per neuron, each attribute (membrane potential, time of the last spike,
+ * clock, state and ring buffer) is kept in its own contiguous array and a neuron is only an index in these arrays.
+ * A step of the simulation then goes through the arrays in order instead of following a pointer for each neuron.
+ * The parameters which are the same for all the neurons (g, etha, J_inhibitory, externalFrequency) are stored once.
+ * The neurons are in groups (NeuronGroup) whose parameters are also stored once: the amplitude of their spikes,
+ * the rate of their random spikes, the threshold and the refractory period. A neuron only keeps the index of its
+ * group (one byte). By default there are the two groups of the article, the excitatory neurons then the inhibitory ones.
+ * The random spikes received by the neuron i at a step only depend on the seed of the population, i and the step
+ * (counter based generator), so the neurons can be updated in any order or by any thread with the same result.
+ * They are drawn for a whole block at once by the PoissonSampler of the group, made for its rate.
+ * A block given to the kernel stops at the end of a group, so all its neurons have the same threshold.
+ *
+ * Real is the type of the membrane potentials and of the ring buffers: NeuronPopulation is in double precision,
+ * FloatNeuronPopulation in single precision moves half the bytes in the update and the delivery, which are limited
+ * by the memory. The amplitudes (0.1, -0.5) and the threshold (20) don't need more than the 24 bits of a float,
+ * the spikes are not exactly the same as in double precision but the rates and the regimes are.
+ *
+ * All the synapses of a group have the same amplitude, so the ring buffers can hold the number of spikes received
+ * from each group (COUNT_RING_BUFFER) instead of the sum of the amplitudes: a delivery is an increment of a 16 bits
+ * integer and the amplitudes are multiplied in once, when the update reads the slot of the step. With the two
+ * groups of the article it takes 4 bytes per neuron and per slot instead of 8 in double precision. A count holds
+ * the spikes of one step, so it only overflows if more than 65535 neurons of a group connected to the same target
+ * spike at the same step. The sums are not made in the same order, so the spikes are not exactly the same as with
+ * the amplitudes.
+ *
+ * The random spikes are only used by the neurons which integrate their inputs. With ACTIVE_NEURONS_SCHEDULING the
+ * update first makes the list of the active neurons of the block (not refractory and below the threshold), and
+ * the random spikes are only drawn for them. The spikes are exactly the same as with all the neurons, since a
+ * neuron gets the same random spikes whatever the others. The refractory neurons are still lanes of the vectors
+ * of the kernel, the list only saves the draws, so it is slower when few neurons are refractory.
+ */
+
+template<typename Real>
+class BasicNeuronPopulation {
+
+	public:
+
+	/*!
+     * Constructor of the class BasicNeuronPopulation
+     * All the neurons start non refractory with a membrane potential of 0 and an empty ring buffer
+     * @param size: the number of neurons of the population; excitatory: how many of them are excitatory
+     * @param seed: the seed of the random spikes coming from the rest of the brain
+     */
+	BasicNeuronPopulation(unsigned long size = totalN, unsigned long excitatory = excitatoryNeurons,
+					 unsigned int seed = std::random_device()());
+
+	/*!
+     * Constructor of the class BasicNeuronPopulation with other groups than the ones of the article
+     * @param groups: the parameters of each group, at most 256 groups, the neurons of a group follow each other
+     * @param seed: the seed of the random spikes coming from the rest of the brain
+     */
+	BasicNeuronPopulation(const std::vector<NeuronGroup>& groups, unsigned int seed = std::random_device()());
+
+	/*!
+	 * @param var: a value for g
+	 * Setter for the value of g and J_inhibitory based on g, for the whole population
+     */
+	void setG(double var);
+
+	/*!
+	 * @param e: a value for the parameter etha
+	 * Setter for etha and the value of the external frequency based on etha, for the whole population
+     */
+	void setEtha(double e);
+
+	/*!
+	 * @param seed: a value for the seed
+	 * Setter for the seed of the random spikes of all the neurons
+     */
+	void setSeed(unsigned int seed);
+
+	/*!
+	 * @param kernel: the instruction set used to update the neurons
+	 * Setter for the kernel of the update, by default the best one supported by the processor is used
+     */
+	void setKernel(KernelType kernel);
+
+	/*!
+	 * @param type: AMPLITUDE_RING_BUFFER or COUNT_RING_BUFFER
+	 * Setter for the contents of the ring buffers, by default the amplitudes. The ring buffers are emptied,
+	 * so it is called before the simulation.
+     */
+	void setRingBufferType(RingBufferType type);
+
+	/*!
+	 * @param type: ALL_NEURONS_SCHEDULING or ACTIVE_NEURONS_SCHEDULING
+	 * Setter for the neurons which receive random spikes, by default all the neurons of a block
+     */
+	void setScheduling(SchedulingType type);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Getter for the number of neurons in the population
+	 * @return the size of the arrays
+     */
+	unsigned long size() const;
+
+	/*!
+	 * Getter for the relative strength g of the connections
+	 * @return g
+     */
+	double getG() const;
+
+	/*!
+	 * Getter for the ratio etha between the external frequency and the thresold frequency
+	 * @return etha
+     */
+	double getEtha() const;
+
+	/*!
+	 * Getter for the amplitude of the spikes of the inhibitory neurons
+	 * @return J_inhibitory
+     */
+	double getJInhibitory() const;
+
+	/*!
+	 * Getter for the rate of the random spikes coming from the rest of the brain
+	 * @return externalFrequency
+     */
+	double getExternalFrequency() const;
+
+	/*!
+	 * Getter for the membrane potential of the neuron i
+	 * @return membranePotential[i]
+     */
+	double getMembranePotential(unsigned long i) const;
+
+	/*!
+	 * Getter for the number of spikes fired by the neuron i
+	 * @return spikes[i]
+     */
+	unsigned int getSpikes(unsigned long i) const;
+
+	/*!
+	 * Getter for the time at which the neuron i fired its last spike
+	 * @return spikesOccured[i]
+     */
+	int getSpikesOccured(unsigned long i) const;
+
+	/*!
+	 * Getter for the state of the neuron i
+	 * @return state[i]
+     */
+	State getState(unsigned long i) const;
+
+	/*!
+	 * Getter for the local clock of the neuron i
+	 * @return clock[i]
+     */
+	int getClock(unsigned long i) const;
+
+	/*!
+	 * Getter for the type of the neuron i, if it's excitatory of inhibitory
+	 * @return true if the group of the neuron is excitatory
+     */
+	bool getExcitatory(unsigned long i) const;
+
+	/*!
+	 * Getter for the group of the neuron i
+	 * @return the index of the group in getGroups()
+     */
+	unsigned int getGroup(unsigned long i) const;
+
+	/*!
+	 * Getter for the parameters of the groups of the population
+	 * @return groups
+     */
+	const std::vector<NeuronGroup>& getGroups() const;
+
+	/*!
+	 * Getter for the amplitude of the spikes of the neurons of the group k, given by its weight and g
+	 * @return amplitude[k]
+     */
+	double getAmplitude(unsigned int k) const;
+
+	/*!
+	 * Getter for the contents of the ring buffers
+	 * @return ringBufferType
+     */
+	RingBufferType getRingBufferType() const;
+
+	/*!
+	 * Getter for the neurons which receive random spikes
+	 * @return scheduling
+     */
+	SchedulingType getScheduling() const;
+
+	/*!
+	 * Getter for the value of the ring buffer of neuron i at index "index"
+	 * @return the amplitude stored for this time (the counts times the amplitudes of their groups)
+     */
+	double getRingBuffer(unsigned long i, unsigned int index) const;
+
+	/*!
+	 * Getter for the plasticity of the synapses
+	 * @return the plasticity attached to the population, nullptr if the synapses are static
+     */
+	const Plasticity* getPlasticity() const;
+
+	/*!
+	 * Getter for the neurons which have spiked during the last update
+	 * @return the indexes of the spiking neurons, in increasing order
+     */
+	const std::vector<uint32_t>& getSpiking() const;
+
+	/*!
+	 * Gives a copy of the neuron i as a Neuron object, to inspect it with the API of the class Neuron
+	 * (the class Neuron has the threshold and the refractory period of the article)
+	 * @return a Neuron with the same state as the neuron i (without its targets)
+     */
+	Neuron getNeuron(unsigned long i) const;
+
+	///////////////////////SETTERS////////////////////
+
+	/*!
+	 * @param i: the index of a neuron; potential: a value for a potential
+	 * Setter for the membrane potential of the neuron i
+     */
+	void setMembranePotential(unsigned long i, double potential);
+
+	/*!
+	 * @param i, index, J: the index of a neuron, an index of the buffer and a value for the amplitude
+	 * Increases the ring buffer of the neuron i at index "index" of J, only for the ring buffers of amplitudes
+     */
+	void setRingBuffer(unsigned long i, unsigned int index, double J);
+
+	/*!
+	 * @param connectivity: the connections between the neurons of the population
+	 * Setter for the connections used to find the targets of a spiking neuron, they are not copied
+     */
+	void setConnectivity(const Connectivity& connectivity);
+
+	/*!
+	 * @param connectivity: connections drawn again at each spike instead of being stored
+	 * Setter for procedural connections, they replace the stored ones, they are not copied
+     */
+	void setConnectivity(const ProceduralConnectivity& connectivity);
+
+	/*!
+	 * @param recorder: a recorder of some neurons, it is not copied
+	 * Attaches a recorder: the updates give it the potentials of its neurons after each step of its window,
+	 * recordSpikes gives it the spikes
+     */
+	void addRecorder(NeuronRecorder& recorder);
+
+	/*!
+	 * @param synapses: the plasticity of the stored connections of the population, it is not copied
+	 * Attaches a plasticity: the spikes are then delivered with the weights of their synapses, which change with
+	 * the spikes. Only with the stored connections and the ring buffers of amplitudes.
+     */
+	void setPlasticity(Plasticity& synapses);
+
+	/*!
+	 * @param bounds: the first neuron of the range of each thread, and the end of the last range
+	 * Gives the ranges of the threads to the plasticity, which keeps the traces of the pre spikes for each one
+     */
+	void setPartition(const std::vector<unsigned long>& bounds);
+
+	/////////////////////////OTHER FUNCTIONS///////////////////////
+
+	/*!
+	 * @param i: the index of the neuron which receives the spikes; step: the time of the reception
+	 * Calculates randomly a number of spikes that the neuron i receives from the rest of the brain at this step
+	 * @return the number of random spikes times the value of the excitatory amplitude
+     */
+	double externalSpikes(unsigned long i, unsigned long step) const;
+
+	/*!
+	 * @param step: the simulation time at which the update must be done
+	 * @param I: the input current received by the neurons
+	 * Updates all the neurons of the population for one step, the same way as Neuron::update does for one neuron.
+	 * The ring buffer entry read during the step is cleared for every neuron, so an input arriving
+	 * while the neuron is refractory is lost instead of coming back D+1 steps later.
+	 * Once all the neurons are updated, the spikes are recorded and the spiking neurons fill the ring buffer of their targets.
+     */
+	void update(unsigned long step, double I);
+
+	/*!
+	 * @param step, I: the simulation time and the input current
+	 * @param first, last: the neurons from first to last (excluded) are updated, first must start a block
+	 * @param spikingNeurons: the indexes of the neurons of the range which spike are added to it
+	 * Updates a range of neurons for one step without filling the ring buffer of any target,
+	 * different ranges can be updated at the same time by different threads.
+	 * The random spikes of a whole block are drawn in one call, then the block is updated by the kernel
+	 * (the spikes of the neurons which are refractory or spiking are not used). The recorders of potentials
+	 * keep the potentials of the block after the update. The version of the update compiled for the ring buffers
+	 * and the kernel of the population is chosen when they are set, not at each block.
+     */
+	void update(unsigned long step, double I, unsigned long first, unsigned long last, std::vector<uint32_t>& spikingNeurons);
+
+	/*!
+	 * @param step: the first step of the window; I: the input current
+	 * @param first, last: the neurons from first to last (excluded) are updated, first must start a block
+	 * @param spikingNeurons: spikingNeurons[k] receives the indexes of the neurons of the range which spike at step+k
+	 * Updates a range of neurons for several steps (as many as spikingNeurons has lists) without filling the ring
+	 * buffer of any target. Each block makes all the steps before the next block, so its neurons stay in the cache.
+	 * The window must not be longer than D steps: a spike of the window reaches its targets D steps later, after
+	 * the end of the window, so the spikes can be delivered once the whole window is done.
+     */
+	void update(unsigned long step, double I, unsigned long first, unsigned long last,
+				std::vector<std::vector<uint32_t> >& spikingNeurons);
+
+	/*!
+	 * @param i: the index of the neuron which spiked; step: the simulation time of the spike
+	 * Fills the ring buffer of the targets of the neuron i with the amplitude of its group (or adds one to the count
+	 * of its group, or the weights of its synapses with a plasticity)
+     */
+	void fillRingBufferOfTargets(unsigned long i, unsigned long step);
+
+	/*!
+	 * @param i: the index of the neuron which spiked; step: the simulation time of the spike
+	 * @param first, last: only the targets from first to last (excluded) receive the spike
+	 * Fills the ring buffer of the targets of the neuron i which are in the range, as the targets are sorted
+	 * the range is found by a binary search. A thread only writes in the ring buffer of its own neurons this way.
+     */
+	void fillRingBufferOfTargets(unsigned long i, unsigned long step, unsigned long first, unsigned long last);
+
+	/*!
+	 * @param step: the simulation time of the spikes; sources: the neurons which spiked, in increasing order
+	 * @param first, last: only the targets from first to last (excluded) receive the spikes
+	 * Fills the ring buffer of the targets of all the spikes of a step which are in the range, tile by tile:
+	 * all the spikes write in a tile of deliveryTile neurons before going to the next one, so the writes stay
+	 * in a part of the ring buffer small enough for the cache instead of going all over the range for each spike.
+	 * Each source keeps its position in its sorted targets from a tile to the next. The inputs of a neuron are
+	 * added in the same order as with fillRingBufferOfTargets, so the result is exactly the same.
+	 * With a plasticity, the spikes go to the plasticity which also changes the weights of the range.
+     */
+	void deliverSpikes(unsigned long step, const std::vector<uint32_t>& sources, unsigned long first, unsigned long last);
+
+	/*!
+	 * @param step: the simulation time of the spikes; spikes: neurons which spiked, in increasing order
+	 * Gives the spikes to the recorders of spikes, the spikes of a step can be given in several lists
+	 * (one per thread) if the indexes keep increasing
+     */
+	void recordSpikes(unsigned long step, const std::vector<uint32_t>& spikes);
+
+	/*!
+	 * @param out: a binary file, at a multiple of 8 bytes
+	 * Writes the state of all the neurons: g, etha, the seed of the random spikes, the membrane potentials,
+	 * the numbers and times of the spikes, the states, the clocks and the ring buffers. The random spikes only
+	 * depend on the seed and the step, so the seed is the whole state of the generator.
+	 * The potentials and the ring buffers are written in the precision of the population, only with the ring
+	 * buffers of amplitudes.
+     */
+	void write(std::ostream& out) const;
+
+	/*!
+	 * @param in: a binary file at the position of a state written by write, for a population of the same size
+	 * (and the same size of the first group), with the ring buffers of amplitudes
+	 * Reads the state of all the neurons, the connectivity is not changed
+	 * @return false if the file ends before or is for another size
+     */
+	bool read(std::istream& in);
+
+	private:
+
+	/*!
+	 * @param step, I, first, last, spikingNeurons: the same as for update
+	 * Updates a range of neurons for one step with the ring buffers and the kernel given at compile time,
+	 * the branches of the other types are not compiled in the loop of the blocks
+     */
+	template<RingBufferType buffers, KernelType type>
+	void updateBlocks(unsigned long step, double I, unsigned long first, unsigned long last, std::vector<uint32_t>& spikingNeurons);
+
+	/*!
+	 * Chooses the version of updateBlocks for the type of the ring buffers and the kernel
+     */
+	void selectUpdate();
+
+	/*!
+	 * @param i: the index of the neuron which spiked; buffer: the slot of the ring buffers which receives the spike
+	 * @param value: the value added to the slot of each target
+	 * @param first, last: only the targets from first to last (excluded) receive the spike
+	 * Adds the value to the slot of the targets of the neuron i which are in the range
+     */
+	template<typename Value>
+	void addToTargets(unsigned long i, Value* buffer, Value value, unsigned long first, unsigned long last);
+
+	/*!
+	 * @param buffers, values: the slot of the ring buffers and the value of each source
+	 * @param next, end: the next target of each source in the range, and the end of its targets in the range
+	 * @param first, last: the range of the targets
+	 * Adds the value of each source to the slot of its targets, tile by tile
+     */
+	template<typename Value>
+	void deliverTiles(const std::vector<Value*>& buffers, const std::vector<Value>& values, std::vector<const uint32_t*>& next,
+					  const std::vector<const uint32_t*>& end, unsigned long first, unsigned long last);
+
+	unsigned long numberNeurons; //!< number of neurons in the population
+	std::vector<NeuronGroup> groups; //!< parameters of each group
+	std::vector<unsigned long> groupEnd; //!< index after the last neuron of each group
+	std::vector<uint8_t> group; //!< group of each neuron
+	std::vector<double> amplitude; //!< amplitude of the spikes of each group, given by its weight and g
+
+	double g; //!< relative strenghts of connections g=J_inhibitory/J_excitatory
+	double etha; //!< value of externalFrequency over thresold frequency
+	double J_inhibitory; //!< amplitude of the spike of an inhibitory neuron
+	double externalFrequency; //!< rate at which a neuron receives a random spike
+
+	std::vector<Real> membranePotential; //!< membrane potential of each neuron
+	std::vector<unsigned int> spikes; //!< number of spikes fired by each neuron
+	std::vector<int> spikesOccured; //!< time of the last spike of each neuron
+	std::vector<State> state; //!< state of each neuron
+	std::vector<int> clock; //!< local clock of each neuron
+	RingBufferType ringBufferType; //!< contents of the ring buffers, amplitudes or counts
+	std::vector<Real> ringBuffer; //!< D+1 slots of numberNeurons values, the slot t holds the inputs of all the neurons for the time t
+	std::vector<SpikeCount> spikeCounts; //!< D+1 slots of one array of numberNeurons counts per group, used instead of ringBuffer
+	SchedulingType scheduling; //!< neurons of a block which receive random spikes, all or the active ones
+	const Connectivity* connections; //!< targets of each neuron, owned by the network
+	const ProceduralConnectivity* procedural; //!< connections drawn at each spike, used instead of connections if not null
+	Plasticity* plasticity; //!< weights of the stored connections if not null, owned by the caller
+	UpdateKernel kernel; //!< kernel which updates the neurons block by block
+	void (BasicNeuronPopulation::*updater)(unsigned long, double, unsigned long, unsigned long, std::vector<uint32_t>&); //!< version of updateBlocks used by update
+	std::vector<uint32_t> spiking; //!< indexes of the neurons that have spiked during the last update
+	std::vector<NeuronRecorder*> recorders; //!< recorders attached to the population, owned by the caller
+
+	std::vector<PoissonSampler> samplers; //!< generator of the random spikes coming from the rest of the brain, for each group
+};
+
+typedef BasicNeuronPopulation<double> NeuronPopulation; //!< population in double precision
+typedef BasicNeuronPopulation<float> FloatNeuronPopulation; //!< population in single precision
+
+#endif
@@ -0,0 +1,135 @@
+#include "NeuronRecorder.hpp"
+#include "Neuron.hpp"
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+	/*!
+	 * @return the indexes from first to last (excluded)
+     */
+	vector<uint32_t> range(unsigned long first, unsigned long last)
+	{
+		vector<uint32_t> indexes;
+		for(unsigned long i(first); i < last; ++i) {
+			indexes.push_back(i);
+		}
+		return indexes;
+	}
+
+}
+
+NeuronRecorder::NeuronRecorder(RecordedVariable var, const vector<uint32_t>& recorded, unsigned long first, unsigned long end,
+							   unsigned long every)
+	:variable(var), neurons(recorded), start(first), stop(max(first, end)), stride(max(1ul, every))
+{
+	assert(is_sorted(neurons.begin(), neurons.end()));
+	if(variable == POTENTIAL_RECORDING) {
+		potentials.assign(getSamples()*neurons.size(), 0.0);
+	} else { //a neuron spikes at most once per refractory period
+		spikes.reserve(2*neurons.size()*min(getSamples(), (stop-start)/(taurp+1)+1));
+	}
+}
+
+NeuronRecorder::NeuronRecorder(RecordedVariable var, unsigned long first, unsigned long last, unsigned long begin, unsigned long end,
+							   unsigned long every)
+	:NeuronRecorder(var, range(first, last), begin, end, every)
+{}
+
+void NeuronRecorder::recordSpikes(unsigned long step, const vector<uint32_t>& spiking)
+{
+	if(variable != SPIKE_RECORDING or !records(step) or neurons.empty()) {
+		return;
+	}
+	//only the spikes between the first and the last recorded neuron are looked at
+	auto spike(lower_bound(spiking.begin(), spiking.end(), neurons.front()));
+	const auto end(upper_bound(spike, spiking.end(), neurons.back()));
+	auto neuron(neurons.begin());
+	for(; spike != end; ++spike) {
+		neuron = lower_bound(neuron, neurons.end(), *spike); //both lists are increasing
+		if(*neuron == *spike) {
+			spikes.push_back(step);
+			spikes.push_back(*spike);
+		}
+	}
+}
+
+template<typename Real>
+void NeuronRecorder::recordPotentials(unsigned long step, unsigned long first, unsigned long last, const Real* potential)
+{
+	if(variable != POTENTIAL_RECORDING or !records(step)) {
+		return;
+	}
+	//the recorded neurons of the block, each one has its own place in the array
+	const auto begin(lower_bound(neurons.begin(), neurons.end(), first));
+	const auto end(lower_bound(begin, neurons.end(), last));
+	double* const sample(&potentials[(step-start)/stride*neurons.size()]);
+	for(auto neuron(begin); neuron != end; ++neuron) {
+		sample[neuron-neurons.begin()] = potential[*neuron-first];
+	}
+}
+
+////////////////GETTERS//////////////////////
+
+RecordedVariable NeuronRecorder::getVariable() const
+{
+	return variable;
+}
+
+const vector<uint32_t>& NeuronRecorder::getNeurons() const
+{
+	return neurons;
+}
+
+unsigned long NeuronRecorder::getSamples() const
+{
+	return (stop-start+stride-1)/stride;
+}
+
+const vector<uint32_t>& NeuronRecorder::getSpikes() const
+{
+	return spikes;
+}
+
+double NeuronRecorder::getPotential(unsigned long sample, unsigned long n) const
+{
+	assert(variable == POTENTIAL_RECORDING and sample < getSamples() and n < neurons.size());
+	return potentials[sample*neurons.size() + n];
+}
+
+/////////////////////////OTHER FUNCTIONS///////////////////////
+
+bool NeuronRecorder::write(const string& fileName) const
+{
+	ofstream file(fileName);
+	if(file.fail()) {
+		cerr << "Error opening the file of the recorder " << fileName << endl;
+		return false;
+	}
+	if(variable == SPIKE_RECORDING) {
+		for(size_t s(0); s < spikes.size(); s += 2) {
+			file << spikes[s] << '\t' << spikes[s+1] << '\n';
+		}
+		return !file.fail();
+	}
+	file << "# step";
+	for(auto i : neurons) {
+		file << '\t' << i;
+	}
+	file << '\n';
+	for(unsigned long sample(0); sample < getSamples(); ++sample) {
+		file << start+sample*stride;
+		for(size_t n(0); n < neurons.size(); ++n) {
+			file << '\t' << potentials[sample*neurons.size() + n];
+		}
+		file << '\n';
+	}
+	return !file.fail();
+}
+
+template void NeuronRecorder::recordPotentials<double>(unsigned long step, unsigned long first, unsigned long last, const double* potential);
+template void NeuronRecorder::recordPotentials<float>(unsigned long step, unsigned long first, unsigned long last, const float* potential);
@@ -0,0 +1,125 @@
+#ifndef NEURONRECORDER_HPP
+#define NEURONRECORDER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*!
+ * @file NeuronRecorder.hpp
+ * variable kept by a recorder: the spikes or the membrane potentials of its neurons
+ */
+enum RecordedVariable {SPIKE_RECORDING, POTENTIAL_RECORDING};
+
+/*!
+ * @class NeuronRecorder
+ * Class that keeps a variable of some neurons during a window of steps, one step every stride steps, instead
+ * of all the spikes of the network. A recorder is attached to a population (addRecorder), which gives it the
+ * spikes of each step and the potentials of each block after its update, so it works with the threads and the
+ * epochs of a simulation. The potentials are stored in an array allocated for the whole window when the recorder
+ * is created, and each thread writes the neurons of its own range, so there is no lock. The spikes are given by one
+ * thread; the array is reserved for a neuron spiking at the end of each refractory period. The recorder only reads the
+ * neurons it records, so its cost depends on what is recorded, not on the activity of the network. Everything is
+ * written at the end by write.
+ */
+
+class NeuronRecorder {
+
+	public:
+
+	/*!
+     * Constructor of the class NeuronRecorder for a list of neurons
+     * @param variable: the spikes or the membrane potentials
+     * @param neurons: the indexes of the recorded neurons, in increasing order
+     * @param start, stop: the steps of the window, from start to stop (excluded)
+     * @param stride: the number of steps between two recorded steps
+     */
+	NeuronRecorder(RecordedVariable variable, const std::vector<uint32_t>& neurons, unsigned long start, unsigned long stop,
+				   unsigned long stride = 1);
+
+	/*!
+     * Constructor of the class NeuronRecorder for a range of neurons
+     * @param variable: the spikes or the membrane potentials
+     * @param first, last: the neurons from first to last (excluded)
+     * @param start, stop: the steps of the window, from start to stop (excluded)
+     * @param stride: the number of steps between two recorded steps
+     */
+	NeuronRecorder(RecordedVariable variable, unsigned long first, unsigned long last, unsigned long start, unsigned long stop,
+				   unsigned long stride = 1);
+
+	/*!
+	 * @param step: a step of the simulation
+	 * @return true if the step is in the window and is one of the recorded steps
+     */
+	bool records(unsigned long step) const
+	{
+		return step >= start and step < stop and (step-start)%stride == 0;
+	}
+
+	/*!
+	 * @param step: the time of the spikes; spikes: indexes of neurons which spiked, in increasing order
+	 * Keeps the spikes of the recorded neurons, a step can be given in several lists if the indexes keep increasing
+     */
+	void recordSpikes(unsigned long step, const std::vector<uint32_t>& spikes);
+
+	/*!
+	 * @param step: the step which was just updated
+	 * @param first, last: a block of neurons; potentials: the potential of each neuron of the block
+	 * Keeps the potentials of the recorded neurons of the block, the blocks can be given by several threads at once
+     */
+	template<typename Real>
+	void recordPotentials(unsigned long step, unsigned long first, unsigned long last, const Real* potentials);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Getter for the recorded variable
+	 * @return variable
+     */
+	RecordedVariable getVariable() const;
+
+	/*!
+	 * Getter for the recorded neurons
+	 * @return neurons, in increasing order
+     */
+	const std::vector<uint32_t>& getNeurons() const;
+
+	/*!
+	 * Getter for the number of recorded steps of the window
+	 * @return the number of samples of the potentials
+     */
+	unsigned long getSamples() const;
+
+	/*!
+	 * Getter for the spikes kept
+	 * @return the time and the index of each spike, one after the other
+     */
+	const std::vector<uint32_t>& getSpikes() const;
+
+	/*!
+	 * @param sample: a recorded step, the step start+sample*stride; n: the position of a neuron in getNeurons
+	 * @return the membrane potential of the neuron after the update of the step
+     */
+	double getPotential(unsigned long sample, unsigned long n) const;
+
+	/*!
+	 * @param fileName: the name of the text file to create
+	 * Writes what was recorded: a line "time  index" per spike (the format of raster.gdf), or a line per recorded
+	 * step with the time and the potential of each neuron, after a line "# step" and the indexes of the neurons
+	 * @return false if the file can't be opened
+     */
+	bool write(const std::string& fileName) const;
+
+	private:
+
+	RecordedVariable variable; //!< spikes or membrane potentials
+	std::vector<uint32_t> neurons; //!< indexes of the recorded neurons, in increasing order
+	unsigned long start; //!< first step of the window
+	unsigned long stop; //!< end of the window
+	unsigned long stride; //!< steps between two recorded steps
+	std::vector<uint32_t> spikes; //!< time and index of each spike kept
+	std::vector<double> potentials; //!< potentials of all the neurons for each recorded step, one step after the other
+
+};
+
+#endif
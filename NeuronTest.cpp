@@ -1,55 +1,289 @@
 #include "Neuron.hpp"
 #include "Network.hpp"
+#include "NeuronPopulation.hpp"
+#include "Simulation.hpp"
+#include "SpikeWriter.hpp"
+#include "SpikeAnalysis.hpp"
+#include "Sweep.hpp"
+#include "Configuration.hpp"
+#include "SpikeTransport.hpp"
+#include "Instrumentation.hpp"
+#include "NeuronRecorder.hpp"
+#include "BrunelSimulator.hpp"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <cassert>
 #include <array>
+#include <cstdlib>
+#include <thread>
+#include <memory>
+#include <string>
+#include <random>
 
 using namespace std;
 
 constexpr unsigned long n_start(0); //first step of the simulation
+constexpr unsigned long n_print(1000); //the step is printed every n_print steps
 
-int main() 
+/*!
+ * Sweep mode: "./Neuron --sweep [points] [threads] [spikes]", the points (g, etha) are read in a file,
+ * by default the four graphs of ReadMe.txt are simulated. The connections are built once for all the points.
+ */
+int sweep(const vector<string>& arguments, const Configuration& configuration, const NetworkSize& size)
 {
+	vector<SweepPoint> points = {{3.0, 2.0}, {6.0, 4.0}, {5.0, 2.0}, {4.5, 0.9}}; //graphs (a) to (d)
+	if(arguments.size() > 0) {
+		points = Sweep::readPoints(arguments[0]);
+		if(points.empty()) {
+			return 1;
+		}
+	}
+	unsigned int threads(configuration.getUnsigned("threads", thread::hardware_concurrency()));
+	if(arguments.size() > 1) {
+		threads = atoi(arguments[1].c_str());
+	}
+	const bool writeSpikes(arguments.size() > 2 and arguments[2] == "spikes"); //all the spikes of each point in a binary file
 	
-	Network net; //network with all the neurons
-	unsigned int n(n_start); //actual step of the simulation
-	double I(0.0); //external input current
-	int ind(0); //index of each neuron, number id
-	
-	
-	net.initializeNetwork(); //the network is initialized at 12500 neurons
-	
-	ofstream file;
-	file.open("spikes.gdf");
-	
-	if(file.fail()) { 
-		cerr << "Error opening text file" << endl; 
-	} else {
-		
-		net.instaureConnections(); //connections between the neurons are created, 1250 connections
-		
-		do { //while we don't reach the total steps of the simulation
-			
-			cout << "Step " << n << endl;
-			
-			for(auto neuron : net.getNeurons() ) { //for each neuron
-				neuron->update(n, I, false, false); //gets updated
-				if(neuron->getSpk()) { //if there was a spike, we write it in a file with the id of the neuron
-					file << neuron->getSpikesOccured() << '\t' << ind << '\n';
-				}
-				++ind; //index of the neuron in the vector of class network
-			}
-			
-			ind = 0; //for each while we start back at zero
-			++n; //increase of the steps of the simulation 
-			
-		} while(n < n_stop);
-
+	//only the connections of the network are used, each point has its own neurons
+	Network net(size, configuration.getUnsigned("seed", random_device()()));
+	net.instaureConnections();
+	Sweep sweep(net.getConnectivity(), size.excitatory, net.getSeed(), threads);
+	cout << "Sweep of " << points.size() << " points on " << threads << " threads" << endl;
+	
+	const bool written(sweep.run(points, n_start, n_stop, 0.0, writeSpikes));
+	for(size_t p(0); p < points.size(); ++p) {
+		cout << "g=" << points[p].g << " etha=" << points[p].etha << ": mean rate "
+			 << sweep.getAnalysis(p).getMeanRate(0, size.total()) << " Hz" << endl;
+	}
+	//the results of each point are in its own files, the rates of all the points in sweep.txt
+	if(!written or !sweep.write("sweep.txt")) {
+		return 1;
 	}
+	return 0;
+}
 
-	system("python pythonScript.py &");
+/*!
+ * Normal mode: "./Neuron [threads] [spikesBinaryFile]", one simulation with the values of g and etha
+ * of the configuration, or asked if they are not given. With processes=P the neurons are shared between P processes
+ * of this machine, with an MPI transport between the processes started by mpirun. The network and the steps are made
+ * by libbrunel (BrunelSimulator), this mode adds the recording of the spikes, the metrics, the checkpoint and the files.
+ */
+int simulate(const vector<string>& arguments, Configuration configuration, SpikeTransport* mpi)
+{
+	//all the processes need the same seed, the one of the process 0 is sent to the others
+	unsigned int seed(configuration.getUnsigned("seed", random_device()()));
+	if(mpi) {
+		vector<vector<uint32_t> > seeds;
+		if(!mpi->exchange(vector<uint32_t>(1, seed), seeds)) {
+			return 1;
+		}
+		seed = seeds[0][0];
+	}
+	configuration.set("seed", to_string(seed));
+	
+	const unsigned int processes(mpi ? 1 : max(1ul, configuration.getUnsigned("processes", 1)));
+	if((mpi or processes > 1) and configuration.has("record_potentials")) { //the process 0 only updates its range
+		cerr << "The potentials are only recorded with one process" << endl;
+		return 1;
+	}
+	
+	//the number of threads can be given as first argument, by default all the cores are used
+	if(arguments.size() > 0) {
+		if(!configuration.set("threads", arguments[0])) {
+			return 1;
+		}
+	} else if(!configuration.has("threads")) {
+		configuration.set("threads", to_string(max(1u, thread::hardware_concurrency()/processes)));
+	}
+	
+	//g and etha are asked if they are not given, before the other processes are created
+	const bool ask(!configuration.has("restore") and !(configuration.has("g") and configuration.has("etha")));
+	double g(0.0), etha(0.0);
+	if(ask and mpi) {
+		cerr << "g and etha must be given as parameters with MPI" << endl;
+		return 1;
+	} else if(ask) {
+		cout << "Enter g: ";
+		cin >> g;
+		cout << "Enter etha: ";
+		cin >> etha;
+		if(!cin or etha < 0.0) {
+			cerr << "Invalid g or etha, they must be numbers and etha must be positive" << endl;
+			return 1;
+		}
+	}
+	
+	//the other processes are created once the parameters are known, each one builds its own part of the network
+	unique_ptr<SharedMemoryTransport> shared;
+	SpikeTransport* transport(mpi);
+	NetworkSize networkSize;
+	if(!configuration.getNetworkSize(networkSize)) {
+		return 1;
+	}
+	//all the spikes are written in a binary file only if its name is given as second argument
+	const string spikesName(arguments.size() > 1 ? arguments[1] : configuration.getString("spikes"));
+	if(processes > 1) {
+		//the file and the recorders are checked before, an error of the process 0 after spawn() stops the others
+		vector<NeuronRecorder> recorders;
+		if(!configuration.getRecorders(networkSize.total(), 0, n_stop, recorders)) {
+			return 1;
+		}
+		if(!spikesName.empty() and !ofstream(spikesName, ios::binary)) {
+			cerr << "Error opening binary file" << endl;
+			return 1;
+		}
+		//a neuron spikes at most once per step, so a process sends at most its neurons times D spikes per epoch
+		shared.reset(new SharedMemoryTransport(processes, (networkSize.total()/processes+blockSize)*D+D));
+		if(!shared->spawn()) {
+			return 1;
+		}
+		transport = shared.get();
+	}
+	
+	BrunelSimulator brunel;
+	if(!brunel.create(configuration, transport)) {
+		return 1;
+	}
+	if(ask and !brunel.setParameters(g, etha)) {
+		return 1;
+	}
+	networkSize = brunel.getSize(); //the size of a checkpoint
+	
+	const unsigned int rank(transport ? transport->getRank() : 0);
+	const string checkpointName(configuration.getString("checkpoint"));
+	//by default the simulation ends at n_stop, or lasts n_stop steps after a checkpoint restored later
+	unsigned long start(brunel.getStep());
+	const unsigned long stop(start+configuration.getUnsigned("steps", n_stop > start ? n_stop-start : n_stop));
+	if(rank != 0) { //the process 0 receives all the spikes, it is the only one to write them
+		return brunel.run(stop-start, [](unsigned long, const vector<uint32_t>&) {}) ? 0 : 1;
+	}
+	
+	unique_ptr<SpikeWriter> file;
+	if(!spikesName.empty()) {
+		file.reset(new SpikeWriter(spikesName)); //the spikes are written by another thread
+		if(!file->isOpen()) { 
+			cerr << "Error opening binary file" << endl; 
+			return 1;
+		}
+	}
+	//only the neurons and the steps asked are recorded, in memory until the end of the run
+	vector<NeuronRecorder> recorders;
+	if(!configuration.getRecorders(networkSize.total(), start, stop, recorders)) {
+		return 1;
+	}
+	for(auto& recorder : recorders) {
+		brunel.addRecorder(recorder);
+	}
+	//the timers and the counters are written every metricsInterval steps in a file which is replaced each time
+	const string metricsName(configuration.getString("metrics"));
+	const MetricsFormat metricsFormat(configuration.getString("metrics_format") == "prometheus" ? PROMETHEUS_METRICS : JSON_METRICS);
+	const unsigned long metricsInterval(max(1ul, configuration.getUnsigned("metrics_interval", n_print)));
+	if(!metricsName.empty() and !instrumentationEnabled) {
+		cerr << "The program was compiled without BRUNEL_INSTRUMENTATION, the metrics only give the step" << endl;
+	}
+	Instrumentation::global().reset();
+	SpikeAnalysis analysis(networkSize.total(), networkSize.excitatory, start, stop); //statistics of the spikes
+	cout << "Network of " << networkSize.total() << " neurons, " << brunel.getNetwork().getConnectivity().getNumberConnections()
+		 << " stored connections";
+	if(transport) {
+		cout << " in the process 0 of " << transport->getProcesses();
+	}
+	cout << endl;
+	
+	//all the steps of the simulation are made, after each step the spikes are analysed (and written)
+	const BrunelSimulator::Recorder record([&](unsigned long n, const vector<uint32_t>& spikes) {
+		if(n%n_print == 0) {
+			cout << "Step " << n << '\n';
+		}
+		analysis.record(n, spikes);
+		if(file) {
+			file->write(n, spikes);
+		}
+		if(!metricsName.empty() and n%metricsInterval == 0) {
+			Instrumentation::global().snapshot(metricsName, metricsFormat, n);
+		}
+	});
+	bool success(true);
+	if(!checkpointName.empty()) { //the state is saved at a step, by default at the end
+		const unsigned long checkpointStep(min(stop, max(start, configuration.getUnsigned("checkpoint_step", stop))));
+		success = brunel.run(checkpointStep-start, record) and brunel.save(checkpointName);
+		start = checkpointStep;
+	}
+	success = success and brunel.run(stop-start, record);
+	if(file) {
+		success = file->close() and success;
+	}
+	if(!metricsName.empty()) { //the last snapshot has the whole run
+		success = Instrumentation::global().snapshot(metricsName, metricsFormat, stop) and success;
+	}
+	if(shared) {
+		success = shared->wait() and success; //the other processes have finished
+	}
+	if(!success) {
+		return 1;
+	}
+	
+	//the histogram, the rates, the raster and the summary are written in small text files for pythonScript.py
+	if(!analysis.write("")) {
+		return 1;
+	}
+	for(auto const& recorder : recorders) { //recorded_spikes.gdf has the format of raster.gdf
+		if(!recorder.write(recorder.getVariable() == SPIKE_RECORDING ? "recorded_spikes.gdf" : "potentials.txt")) {
+			return 1;
+		}
+	}
+	cout << "Spikes: " << analysis.getTotalSpikes() << ", mean rate: " << analysis.getMeanRate(0, networkSize.total()) << " Hz, regime "
+		 << SpikeAnalysis::getName(analysis.getRegime()) << endl;
+	if(brunel.getPlasticity()) { //the weights of the excitatory synapses towards the neurons of this process
+		cout << "Mean excitatory weight: " << brunel.getPlasticity()->getMeanWeight() << " mV" << endl;
+	}
 	
 	return 0;
 }
+
+int main(int argc, char* argv[]) 
+{
+	//the options and the parameters "key=value" can be anywhere, the other arguments are given to the mode
+	Configuration configuration;
+	vector<string> arguments;
+	bool sweepMode(false), mpi(false);
+	for(int a(1); a < argc; ++a) {
+		const string argument(argv[a]);
+		if(argument == "--config" and a+1 < argc) { //parameters of a configuration file
+			if(!configuration.read(argv[++a])) {
+				return 1;
+			}
+		} else if(argument == "--sweep") {
+			sweepMode = true;
+		} else if(argument == "--mpi") { //the processes are started by mpirun
+			mpi = true;
+		} else if(argument == "--procedural") { //the connections are drawn at each spike instead of being stored
+			configuration.set("connections", "procedural");
+		} else if(argument.find('=') != string::npos) {
+			if(!configuration.set(argument)) {
+				return 1;
+			}
+		} else {
+			arguments.push_back(argument);
+		}
+	}
+	
+	NetworkSize size;
+	if(!configuration.getNetworkSize(size)) {
+		return 1;
+	}
+	if(sweepMode) {
+		return sweep(arguments, configuration, size);
+	}
+	unique_ptr<SpikeTransport> transport;
+	if(mpi) {
+#ifdef BRUNEL_MPI
+		transport.reset(new MpiTransport(&argc, &argv));
+#else
+		cerr << "The program was compiled without MPI" << endl;
+		return 1;
+#endif
+	}
+	return simulate(arguments, configuration, transport.get());
+}
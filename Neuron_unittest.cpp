@@ -2,8 +2,26 @@
 #include <iostream>
 #include "Neuron.hpp"
 #include "Network.hpp"
+#include "NeuronRecorder.hpp"
+#include "Brunel.h"
+#include "Simulation.hpp"
+#include "Sweep.hpp"
+#include "ProceduralConnectivity.hpp"
+#include "Configuration.hpp"
+#include "SpikeTransport.hpp"
+#include "Instrumentation.hpp"
+#include <unistd.h>
+#include "CounterRandom.hpp"
+#include "PoissonSampler.hpp"
+#include "SpikeWriter.hpp"
+#include "SpikeAnalysis.hpp"
+#include "Plasticity.hpp"
+#include <fstream>
+#include <sstream>
 #include "gtest/gtest.h"
 #include <vector>
+#include <algorithm>
+#include <memory>
 
 namespace {
 
@@ -90,8 +108,805 @@ namespace {
 	
 	TEST(TestNetwork, networkSize) {
 		Network net;
-		net.initializeNetwork(); //initialization of the network
-		EXPECT_EQ(net.getNeurons().size(), 12500); //we expect size to be 12500
+		net.initializeNetwork(5.0, 2.0); //initialization of the network, without asking g and etha
+		EXPECT_EQ(net.getPopulation().size(), 12500); //we expect size to be 12500
+		
+		//g and etha which can't be read are refused
+		std::istringstream input("5.0 abc");
+		std::streambuf* const terminal(std::cin.rdbuf(input.rdbuf()));
+		EXPECT_FALSE(net.initializeNetwork());
+		std::cin.rdbuf(terminal);
+		std::cin.clear();
+		EXPECT_EQ(net.getPopulation().getEtha(), 2.0);
+	}
+	
+	/////Test that the population updates a neuron like the class Neuron
+	////////////////////
+	TEST(TestNeuronPopulation, SpikeTimes) {
+		
+		NeuronPopulation population(2, 1);
+		population.setG(5.0);
+		population.setEtha(2.0);
+		Connectivity connections(2);
+		connections.build({1, 0}, 1); //neuron 0 receives from neuron 1 and neuron 1 from neuron 0
+		population.setConnectivity(connections);
+		population.setMembranePotential(0, theta); //neuron 0 spikes at the first update
+		
+		population.update(1, 0.0);
+		ASSERT_EQ(population.getSpiking().size(), 1);
+		EXPECT_EQ(population.getSpiking()[0], 0);
+		EXPECT_EQ(population.getSpikes(0), 1);
+		EXPECT_EQ(population.getState(0), REFRACTORY);
+		EXPECT_NEAR(population.getRingBuffer(1, (1+D)%(D+1)), J_excitatory, 0.001); //input of neuron 1 after the delay
+		
+		Neuron neuron(population.getNeuron(0)); //the same neuron seen with the API of Neuron
+		EXPECT_EQ(neuron.getClock(), 1);
+		EXPECT_EQ(neuron.getSpikesOccured(), 0);
+		EXPECT_TRUE(neuron.getExcitatory());
+		EXPECT_FALSE(population.getNeuron(1).getExcitatory());
+	}
+	
+	/////Test a network of three groups: their connections, amplitudes, thresholds and refractory periods
+	////////////////////
+	TEST(TestNeuronGroup, ThreeGroups) {
+		
+		const std::vector<NeuronGroup> groups = {{800, 1.0, 1.0, theta, taurp}, {100, -1.0, 1.0, theta, taurp},
+												 {100, -0.5, 1.2, 18.0, 30}}; //a second inhibitory group, weaker and slower
+		const std::vector<std::vector<unsigned long> > inDegrees = {{80, 10, 10}, {80, 20, 0}, {40, 0, 10}};
+		Network net(groups, inDegrees, 42);
+		net.initializeNetwork(5.0, 2.0);
+		net.instaureConnections();
+		NeuronPopulation& population(net.getPopulation());
+		EXPECT_EQ(population.size(), 1000);
+		EXPECT_EQ(population.getGroup(850), 1);
+		EXPECT_FALSE(population.getExcitatory(950));
+		EXPECT_NEAR(population.getAmplitude(0), J_excitatory, 1e-12);
+		EXPECT_NEAR(population.getAmplitude(2), -0.5*5.0*J_excitatory, 1e-12);
+		
+		//each neuron receives the connections of its group from each group
+		std::vector<std::vector<unsigned long> > received(3, std::vector<unsigned long>(3, 0));
+		for(unsigned long i(0); i < population.size(); ++i) {
+			for(const uint32_t* t(net.getConnectivity().beginTargets(i)); t != net.getConnectivity().endTargets(i); ++t) {
+				++received[population.getGroup(*t)][population.getGroup(i)];
+			}
+		}
+		for(size_t t(0); t < 3; ++t) {
+			for(size_t s(0); s < 3; ++s) {
+				EXPECT_EQ(received[t][s], inDegrees[t][s]*groups[t].size);
+			}
+		}
+		
+		//the neurons of the last group spike from 18 mV and stay refractory 30 steps
+		unsigned long below(0), spikes(0);
+		std::vector<long> last(population.size(), -1000);
+		for(unsigned long step(0); step < 2000; ++step) {
+			std::vector<double> V(population.size());
+			for(unsigned long i(900); i < population.size(); ++i) {
+				V[i] = population.getMembranePotential(i);
+			}
+			population.update(step, 0.0);
+			for(auto i : population.getSpiking()) {
+				if(i < 900) { continue; }
+				EXPECT_GE(V[i], 18.0);
+				EXPECT_GT(long(step)-last[i], 30);
+				below += (V[i] < theta);
+				last[i] = step;
+				++spikes;
+			}
+		}
+		EXPECT_GT(spikes, 0);
+		EXPECT_GT(below, 0);
+		EXPECT_FALSE(net.save("test_groups.chk", 2000)); //the checkpoints don't have the groups
+	}
+
+	/////Test that the counts of spikes of each group give the same inputs as the amplitudes
+	////////////////////
+	TEST(TestRingBuffer, Counts) {
+
+		const std::vector<NeuronGroup> groups = {{800, 1.0, 1.0, theta, taurp}, {100, -1.0, 1.0, theta, taurp},
+												 {100, -0.5, 1.2, 18.0, 30}};
+		const std::vector<std::vector<unsigned long> > inDegrees = {{80, 10, 10}, {80, 20, 0}, {40, 0, 10}};
+		Network amplitudes(groups, inDegrees, 42), counts(groups, inDegrees, 42);
+		for(Network* net : {&amplitudes, &counts}) {
+			net->initializeNetwork(5.0, 2.0);
+			net->instaureConnections();
+		}
+		counts.getPopulation().setRingBufferType(COUNT_RING_BUFFER);
+		EXPECT_EQ(counts.getPopulation().getRingBufferType(), COUNT_RING_BUFFER);
+		counts.getPopulation().setKernel(SCALAR_KERNEL); //the update compiled for the counts and the scalar kernel
+
+		//the same spikes, the inputs and the potentials only differ by the rounding of the sums
+		unsigned long spikes(0);
+		for(unsigned long step(0); step < 300; ++step) {
+			amplitudes.getPopulation().update(step, 0.0);
+			counts.getPopulation().update(step, 0.0);
+			ASSERT_EQ(amplitudes.getPopulation().getSpiking(), counts.getPopulation().getSpiking());
+			spikes += counts.getPopulation().getSpiking().size();
+		}
+		EXPECT_GT(spikes, 0);
+		for(unsigned long i(0); i < 1000; ++i) {
+			EXPECT_NEAR(amplitudes.getPopulation().getMembranePotential(i), counts.getPopulation().getMembranePotential(i), 1e-9);
+			for(unsigned int t(0); t < D+1; ++t) { //the slot read at the last step is empty again
+				EXPECT_NEAR(amplitudes.getPopulation().getRingBuffer(i, t), counts.getPopulation().getRingBuffer(i, t), 1e-9);
+			}
+			EXPECT_EQ(counts.getPopulation().getRingBuffer(i, 299%(D+1)), 0.0);
+		}
+	}
+
+	/////Test that the random spikes drawn only for the active neurons give exactly the same spikes
+	////////////////////
+	TEST(TestScheduling, SameSpikes) {
+
+		const std::vector<NeuronGroup> groups = {{800, 1.0, 1.0, theta, taurp}, {100, -1.0, 1.0, theta, taurp},
+												 {100, -0.5, 1.2, 18.0, 30}};
+		const std::vector<std::vector<unsigned long> > inDegrees = {{80, 10, 10}, {80, 20, 0}, {40, 0, 10}};
+		for(auto type : {AMPLITUDE_RING_BUFFER, COUNT_RING_BUFFER}) {
+			Network all(groups, inDegrees, 42), active(groups, inDegrees, 42);
+			for(Network* net : {&all, &active}) {
+				net->initializeNetwork(3.0, 2.0); //the synchronous regime, where many neurons are refractory
+				net->instaureConnections();
+				net->getPopulation().setRingBufferType(type);
+			}
+			active.getPopulation().setScheduling(ACTIVE_NEURONS_SCHEDULING);
+			EXPECT_EQ(active.getPopulation().getScheduling(), ACTIVE_NEURONS_SCHEDULING);
+
+			unsigned long spikes(0);
+			for(unsigned long step(0); step < 300; ++step) {
+				all.getPopulation().update(step, 0.0);
+				active.getPopulation().update(step, 0.0);
+				ASSERT_EQ(all.getPopulation().getSpiking(), active.getPopulation().getSpiking());
+				spikes += active.getPopulation().getSpiking().size();
+			}
+			EXPECT_GT(spikes, 1000);
+			for(unsigned long i(0); i < 1000; ++i) {
+				EXPECT_EQ(all.getPopulation().getMembranePotential(i), active.getPopulation().getMembranePotential(i));
+			}
+		}
+	}
+
+	/////Test the connections stored in compressed sparse rows
+	////////////////////
+	TEST(TestConnectivity, Build) {
+		
+		Connectivity connections(3);
+		connections.build({2, 1, 2, 2, 0, 2}, 2); //neuron 0 receives from 2 and 1, neuron 1 from 2 twice, neuron 2 from 0 and 2
+		EXPECT_EQ(connections.getNumberConnections(), 6);
+		EXPECT_EQ(connections.getNumberTargets(0), 1);
+		EXPECT_EQ(connections.getNumberTargets(1), 1);
+		ASSERT_EQ(connections.getNumberTargets(2), 4);
+		std::vector<uint32_t> targets(connections.beginTargets(2), connections.endTargets(2));
+		EXPECT_EQ(targets, std::vector<uint32_t>({0, 1, 1, 2})); //targets are sorted
+	}
+	
+	/////Test that the threads, going by epochs of D steps, give the same spikes as one thread with the same seed
+	////////////////////
+	TEST(TestSimulation, SameAsOneThread) {
+		
+		Network net1(42);
+		Network net2(42);
+		for(auto net : {&net1, &net2}) {
+			net->getPopulation().setG(3.0);
+			net->getPopulation().setEtha(2.0);
+			net->instaureConnections();
+		}
+		
+		std::vector<std::vector<uint32_t> > expected;
+		size_t total(0);
+		for(unsigned long n(0); n < 310; ++n) { //one thread, with the update of the population step by step
+			net1.getPopulation().update(n, 0.0);
+			expected.push_back(net1.getPopulation().getSpiking());
+			total += expected.back().size();
+		}
+		EXPECT_GT(total, 0); //the network is active
+		
+		std::vector<std::vector<uint32_t> > spikes;
+		Simulation simulation(net2.getPopulation(), 3);
+		simulation.run(0, 310, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { spikes.push_back(s); });
+		
+		EXPECT_EQ(spikes, expected);
+		for(size_t i(0); i < totalN; ++i) {
+			ASSERT_EQ(net1.getPopulation().getMembranePotential(i), net2.getPopulation().getMembranePotential(i));
+		}
+	}
+	
+	/////Test that the recorders of a simulation keep the spikes and the potentials of their neurons and steps only
+	////////////////////
+	TEST(TestNeuronRecorder, Window) {
+
+		const NetworkSize size = {800, 200, 80, 20};
+		Network net1(size, 42), net2(size, 42);
+		for(auto net : {&net1, &net2}) {
+			net->initializeNetwork(5.0, 2.0);
+			net->instaureConnections();
+		}
+		std::vector<uint32_t> neurons = {3, 5, 250};
+		for(uint32_t i(600); i < 900; ++i) { neurons.push_back(i); }
+		NeuronRecorder spikes(SPIKE_RECORDING, neurons, 50, 250);
+		NeuronRecorder potentials(POTENTIAL_RECORDING, 100, 400, 40, 300, 7); //on two blocks of neurons
+		net2.getPopulation().addRecorder(spikes);
+		net2.getPopulation().addRecorder(potentials);
+		EXPECT_EQ(potentials.getSamples(), 38);
+		Simulation(net2.getPopulation(), 3).run(0, 310, 0.0, Simulation::Recorder());
+
+		//the same network step by step, all its spikes and potentials are read
+		std::vector<uint32_t> expected;
+		for(unsigned long n(0); n < 310; ++n) {
+			net1.getPopulation().update(n, 0.0);
+			for(auto i : net1.getPopulation().getSpiking()) {
+				if(n >= 50 and n < 250 and std::binary_search(neurons.begin(), neurons.end(), i)) {
+					expected.push_back(n);
+					expected.push_back(i);
+				}
+			}
+			if(potentials.records(n)) {
+				for(unsigned long i(100); i < 400; ++i) {
+					ASSERT_EQ(potentials.getPotential((n-40)/7, i-100), net1.getPopulation().getMembranePotential(i));
+				}
+			}
+		}
+		EXPECT_GT(expected.size(), 0);
+		EXPECT_EQ(spikes.getSpikes(), expected);
+		EXPECT_FALSE(potentials.records(48)); //only one step every 7 steps
+		EXPECT_TRUE(potentials.records(47));
+	}
+
+	/////Test that a pre spike before a post spike potentiates the synapse, that the reverse depresses it, and that
+	/////the weights and the spikes of a network don't depend on the number of threads
+	////////////////////
+	TEST(TestPlasticity, Pairs) {
+
+		Connectivity connections(3);
+		connections.build({1, 0, 0}, 1); //neuron 0 receives from neuron 1, neurons 1 and 2 from neuron 0
+		Plasticity plasticity(connections, {{2, 1.0, 1.0, theta, taurp}, {1, -1.0, 1.0, theta, taurp}});
+		const std::vector<uint8_t> group = {0, 0, 1};
+		std::vector<double> input(3, 0.0);
+		EXPECT_EQ(plasticity.deliver(0, {0}, 0, 3, input.data(), group, {J_excitatory, -0.5}), 2);
+		EXPECT_EQ(plasticity.deliver(10, {1}, 0, 3, input.data(), group, {J_excitatory, -0.5}), 1);
+		EXPECT_NEAR(input[1], J_excitatory, 1e-7);
+		EXPECT_NEAR(input[0], J_excitatory, 1e-7); //the weight before the depression
+
+		//weights in the order of the targets: 0 to 1 and 0 to 2, then 1 to 0; the spikes are 1 ms apart
+		const double potentiated(J_excitatory*(1.0+defaultStdp.potentiation*exp(-1.0/defaultStdp.tauPlus)));
+		const std::vector<float> weights(plasticity.getWeights());
+		EXPECT_NEAR(weights[0], potentiated, 1e-7);
+		EXPECT_NEAR(weights[1], J_excitatory, 1e-7); //neuron 2 didn't spike
+		EXPECT_NEAR(weights[2], J_excitatory*(1.0-defaultStdp.depression*exp(-1.0/defaultStdp.tauMinus)), 1e-7);
+
+		//the window of the neuron 0 ends before its next spike, the potentiation is only made once
+		input.assign(3, 0.0);
+		plasticity.deliver(3000, {0}, 0, 3, input.data(), group, {J_excitatory, -0.5});
+		EXPECT_NEAR(input[1], potentiated, 1e-7);
+		EXPECT_NEAR(plasticity.getWeights()[0], potentiated, 1e-7);
+
+		//one thread by epochs, three threads, more threads than blocks (some ranges are empty) and one step at a time,
+		//longer than the window of the pre traces
+		const unsigned int threads[] = {1, 3, 8};
+		std::vector<std::unique_ptr<Network> > nets;
+		std::vector<std::unique_ptr<Plasticity> > synapses;
+		std::vector<std::vector<uint32_t> > spikes(4);
+		for(unsigned int n(0); n < 4; ++n) {
+			nets.emplace_back(new Network({800, 200, 80, 20}, 42));
+			nets[n]->initializeNetwork(5.0, 2.0);
+			nets[n]->instaureConnections();
+			synapses.emplace_back(new Plasticity(nets[n]->getConnectivity(), nets[n]->getPopulation().getGroups()));
+			nets[n]->getPopulation().setPlasticity(*synapses[n]);
+		}
+		for(unsigned int n(0); n < 3; ++n) {
+			Simulation(nets[n]->getPopulation(), threads[n]).run(0, 2500, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) {
+				spikes[n].insert(spikes[n].end(), s.begin(), s.end());
+			});
+		}
+		for(unsigned long step(0); step < 2500; ++step) {
+			nets[3]->getPopulation().update(step, 0.0);
+			spikes[3].insert(spikes[3].end(), nets[3]->getPopulation().getSpiking().begin(), nets[3]->getPopulation().getSpiking().end());
+		}
+		EXPECT_GT(spikes[0].size(), 0);
+		for(unsigned int n(1); n < 4; ++n) {
+			EXPECT_EQ(spikes[n], spikes[0]);
+			EXPECT_EQ(synapses[n]->getWeights(), synapses[0]->getWeights());
+		}
+		EXPECT_NE(synapses[0]->getMeanWeight(), J_excitatory);
+		EXPECT_FALSE(nets[0]->save("plastic.bin", 2500)); //the weights are not in the checkpoints
+
+		brunel_simulator* simulator(brunel_create("neurons=1000 g=5 etha=2 seed=42 threads=2 plasticity=stdp"));
+		ASSERT_NE(simulator, nullptr);
+		ASSERT_EQ(brunel_run(simulator, 2500), 1);
+		EXPECT_EQ(brunel_mean_weight(simulator), synapses[0]->getMeanWeight());
+		brunel_destroy(simulator);
+		EXPECT_EQ(brunel_create("neurons=1000 plasticity=stdp connections=procedural"), nullptr);
+	}
+
+	/////Test that the C interface of libbrunel runs the same network as the classes, and continues from run to run
+	////////////////////
+	TEST(TestBrunel, SameAsNetwork) {
+
+		brunel_simulator* simulator(brunel_create("neurons=1000 g=5 etha=2 seed=42 threads=2"));
+		ASSERT_NE(simulator, nullptr);
+		EXPECT_EQ(brunel_size(simulator), 1000);
+		ASSERT_EQ(brunel_run(simulator, 200), 1);
+		ASSERT_EQ(brunel_run(simulator, 110), 1); //the spikes and the rates of the second run only
+		EXPECT_EQ(brunel_step(simulator), 310);
+		const uint32_t* spikes(nullptr);
+		const size_t count(brunel_spikes(simulator, &spikes));
+
+		Network net({800, 200, 80, 20}, 42);
+		net.initializeNetwork(5.0, 2.0);
+		net.instaureConnections();
+		std::vector<uint32_t> expected;
+		Simulation(net.getPopulation(), 1).run(0, 310, 0.0, [&](unsigned long n, const std::vector<uint32_t>& s) {
+			for(auto i : s) {
+				if(n >= 200) {
+					expected.push_back(n);
+					expected.push_back(i);
+				}
+			}
+		});
+		EXPECT_GT(expected.size(), 0);
+		EXPECT_EQ(std::vector<uint32_t>(spikes, spikes+2*count), expected);
+		EXPECT_NEAR(brunel_mean_rate(simulator, 0, 1000), count/(1000*110*h*1e-3), 1e-9);
+		EXPECT_EQ(brunel_set_parameters(simulator, 5.0, -1.0), 0); //refused without changing the network
+		EXPECT_EQ(brunel_set_parameters(simulator, 5.0, 2.0), 1);
+		brunel_destroy(simulator);
+
+		EXPECT_EQ(brunel_create("neurons=1000 precision=half"), nullptr);
+		EXPECT_EQ(brunel_create("neurons=1000 unknown=1"), nullptr);
+		EXPECT_EQ(brunel_create("neurons=1000 g=5 etha=-1"), nullptr);
+	}
+
+	/////Update of a block of random neurons by each kernel, compared with the expected update of each neuron
+	////////////////////
+	template<typename Real>
+	void testKernels() {
+		
+		constexpr unsigned long size(37); //not a multiple of the vectors, to use the end of the kernels too
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<Real> potential(0.0, 25.0);
+		std::uniform_int_distribution<int> time(0, 40);
+		
+		std::vector<Real> V(size), input(size), noise(size);
+		std::vector<int> spikeTimes(size), clocks(size, 30);
+		for(size_t i(0); i < size; ++i) {
+			V[i] = potential(generator);
+			input[i] = Real(0.1)*time(generator);
+			noise[i] = Real(0.1)*time(generator);
+			spikeTimes[i] = time(generator);
+		}
+		
+		for(auto type : {SCALAR_KERNEL, AVX2_KERNEL, AVX512_KERNEL}) {
+			if(!UpdateKernel::supported(type)) { continue; }
+			
+			std::vector<Real> V1(V), input1(input);
+			std::vector<int> spikeTimes1(spikeTimes), clocks1(clocks);
+			std::vector<State> states(size);
+			std::vector<unsigned int> spikes(size, 0);
+			std::vector<uint32_t> spiking;
+			const BasicNeuronBlock<Real> block = {100, size, V1.data(), spikeTimes1.data(), clocks1.data(), states.data(),
+												  spikes.data(), input1.data(), noise.data(), Real(theta), taurp};
+			UpdateKernel(type).update(block, Real(0.5), spiking);
+			
+			for(size_t i(0); i < size; ++i) { //the expected update of each neuron
+				const bool refractory(spikeTimes[i] != 0 and spikeTimes[i] <= 30 and 30 < spikeTimes[i]+taurp);
+				const bool fire(!refractory and V[i] >= theta);
+				EXPECT_EQ(V1[i], (refractory or fire) ? Real(0.0) : Real(c1)*V[i] + Real(0.5) + input[i] + noise[i]);
+				EXPECT_EQ(states[i], (refractory or fire) ? REFRACTORY : NON_REFRACTORY);
+				EXPECT_EQ(spikes[i], fire ? 1u : 0u);
+				EXPECT_EQ(spikeTimes1[i], fire ? 30 : spikeTimes[i]);
+				EXPECT_EQ(clocks1[i], 31);
+				EXPECT_EQ(input1[i], Real(0.0));
+				if(fire) {
+					EXPECT_NE(std::find(spiking.begin(), spiking.end(), 100+i), spiking.end());
+				}
+			}
+			EXPECT_TRUE(std::is_sorted(spiking.begin(), spiking.end()));
+		}
+	}
+	
+	/////Test that the vectorized kernels give exactly the same update as the scalar one, in both precisions
+	////////////////////
+	TEST(TestUpdateKernel, SameAsScalar) {
+		
+		testKernels<double>();
+		testKernels<float>();
+	}
+	
+	/////Runs a graph of the article in a population of the precision Real
+	template<typename Real>
+	SpikeAnalysis simulateGraph(const Connectivity& connectivity, double g, double etha, unsigned long steps) {
+		
+		BasicNeuronPopulation<Real> population(totalN, excitatoryNeurons, 42);
+		population.setG(g);
+		population.setEtha(etha);
+		population.setConnectivity(connectivity);
+		SpikeAnalysis analysis(totalN, excitatoryNeurons, 0, steps);
+		BasicSimulation<Real>(population, 1).run(0, steps, 0.0, [&](unsigned long n, const std::vector<uint32_t>& s) { analysis.record(n, s); });
+		return analysis;
+	}
+	
+	/////Test that the four graphs of ReadMe.txt have the same rates and regimes in single and double precision
+	////////////////////
+	TEST(TestPrecision, SameRegimes) {
+		
+		Network net(42);
+		net.instaureConnections(); //the connections don't depend on g and etha
+		const std::vector<std::array<double, 3> > graphs = {{{3.0, 2.0, 2000}}, {{6.0, 4.0, 5000}}, {{5.0, 2.0, 5000}},
+															{{4.5, 0.9, 5000}}}; //(a) is regular after a short run
+		const Regime regimes[] = {SYNCHRONOUS_REGULAR, SYNCHRONOUS_IRREGULAR_FAST, SYNCHRONOUS_IRREGULAR_SLOW,
+								  SYNCHRONOUS_IRREGULAR_SLOW};
+		for(size_t k(0); k < graphs.size(); ++k) {
+			const SpikeAnalysis analysis(simulateGraph<double>(net.getConnectivity(), graphs[k][0], graphs[k][1], graphs[k][2]));
+			const SpikeAnalysis single(simulateGraph<float>(net.getConnectivity(), graphs[k][0], graphs[k][1], graphs[k][2]));
+			const double rate(analysis.getMeanRate(0, totalN));
+			
+			EXPECT_NEAR(single.getMeanRate(0, totalN), rate, 0.02*rate);
+			EXPECT_NEAR(single.getMeanCV(0, totalN), analysis.getMeanCV(0, totalN), 0.02);
+			EXPECT_EQ(analysis.getRegime(), regimes[k]);
+			EXPECT_EQ(single.getRegime(), regimes[k]);
+		}
+	}
+	
+	/////Test the counter based generator: known values of Philox4x32-10 and random spikes independent of the order
+	////////////////////
+	TEST(TestCounterRandom, Reproducible) {
+		
+		const std::array<uint32_t, 4> zero(CounterRandom(0)(0, 0));
+		EXPECT_EQ(zero, (std::array<uint32_t, 4>{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}));
+		
+		NeuronPopulation population(10, 8, 42);
+		population.setG(5.0);
+		population.setEtha(2.0);
+		const double later(population.externalSpikes(3, 100));
+		const double first(population.externalSpikes(7, 2));
+		EXPECT_EQ(population.externalSpikes(7, 2), first); //same neuron and step, same spikes
+		EXPECT_EQ(population.externalSpikes(3, 100), later);
+		
+		Neuron neuron(population.getNeuron(7)); //the neuron with the same index and seed gets the same spikes
+		for(unsigned long step(0); step < 50; ++step) {
+			EXPECT_EQ(neuron.externalSpikes(), population.externalSpikes(7, step));
+			neuron.update(step, 0.0, true, true);
+		}
+	}
+	
+	/////Test that the spikes of the sampler follow the Poisson distribution (chi-squared test) for the rates of the graphs
+	////////////////////
+	TEST(TestPoissonSampler, Distribution) {
+		
+		constexpr unsigned long neurons(1000);
+		constexpr unsigned long steps(200);
+		std::vector<double> noise(neurons);
+		
+		for(double lambda : {0.9, 2.0, 4.0}) {
+			PoissonSampler sampler(lambda, 3);
+			std::vector<double> observed(40, 0.0);
+			double sum(0.0);
+			for(unsigned long step(0); step < steps; ++step) {
+				sampler.fill(noise.data(), 0, neurons, step, 1.0);
+				for(auto k : noise) {
+					++observed[std::min<size_t>(k, observed.size()-1)];
+					sum += k;
+				}
+			}
+			const double total(neurons*steps);
+			EXPECT_NEAR(sum/total, lambda, 0.01); //mean of the distribution
+			
+			//chi-squared on the values expected at least 5 times, the rest is put in the last class
+			double probability(exp(-lambda)), chi2(0.0), rest(total), restObserved(total);
+			int classes(0);
+			for(size_t k(0); k < observed.size() and probability*total >= 5.0; ++k) {
+				chi2 += (observed[k]-probability*total)*(observed[k]-probability*total)/(probability*total);
+				rest -= probability*total;
+				restObserved -= observed[k];
+				++classes;
+				probability *= lambda/(k+1);
+			}
+			chi2 += (restObserved-rest)*(restObserved-rest)/rest;
+			EXPECT_LT(chi2, 3.0*classes+10.0) << "lambda " << lambda; //far above the mean of the chi-squared (classes)
+			
+			//one neuron alone gets the same spikes as in the batch
+			sampler.fill(noise.data(), 0, neurons, 17, 1.0);
+			EXPECT_EQ(sampler.sample(5, 17), noise[5]);
+			EXPECT_EQ(sampler.sample(998, 17), noise[998]);
+		}
+	}
+	
+	/////Test that the binary file of spikes gives back the text format
+	////////////////////
+	TEST(TestSpikeWriter, ConvertToGdf) {
+		
+		std::ostringstream expected;
+		{
+			SpikeWriter writer("test_spikes.bin");
+			ASSERT_TRUE(writer.isOpen());
+			for(unsigned long step(0); step < 3000; ++step) { //more spikes than a block
+				std::vector<uint32_t> spikes;
+				for(uint32_t i(step%7); i < 12500; i += 1000+step) {
+					spikes.push_back(i);
+					expected << step << '\t' << i << '\n';
+				}
+				writer.write(step, spikes);
+			}
+			EXPECT_TRUE(writer.close());
+		}
+		
+		ASSERT_TRUE(SpikeWriter::convertToGdf("test_spikes.bin", "test_spikes.gdf"));
+		std::ifstream gdf("test_spikes.gdf");
+		std::ostringstream text;
+		text << gdf.rdbuf();
+		EXPECT_EQ(text.str(), expected.str());
+		
+		//a full disk is an error of close
+		SpikeWriter full("/dev/full");
+		ASSERT_TRUE(full.isOpen());
+		full.write(0, std::vector<uint32_t>(1000, 1));
+		EXPECT_FALSE(full.close());
+	}
+	
+	/////Test the statistics computed during the simulation
+	////////////////////
+	TEST(TestSpikeAnalysis, Statistics) {
+		
+		SpikeAnalysis analysis(40, 30, 0, 5000);
+		for(unsigned long step(0); step < 5000; ++step) {
+			std::vector<uint32_t> spikes;
+			if(step%100 == 0) { spikes.push_back(0); } //regular neuron
+			if(step%100 == 0 or step%100 == 30) { spikes.push_back(35); } //intervals of 30 and 70
+			analysis.record(step, spikes);
+		}
+		
+		EXPECT_EQ(analysis.getTotalSpikes(), 150);
+		EXPECT_NEAR(analysis.getRate(0), 100.0, 1e-9); //50 spikes in 500 ms
+		EXPECT_NEAR(analysis.getRate(35), 200.0, 1e-9);
+		EXPECT_NEAR(analysis.getCV(0), 0.0, 1e-9);
+		EXPECT_NEAR(analysis.getCV(35), 20.0/50.0, 0.01); //intervals of mean about 50 and standard deviation 20
+		EXPECT_TRUE(std::isnan(analysis.getCV(1))); //no spike
+		EXPECT_EQ(analysis.getHistogram()[0], 2); //first bin of 5 steps
+		EXPECT_EQ(analysis.getHistogram()[6], 1); //step 30
+		EXPECT_EQ(analysis.getRaster().size(), 2*10); //neuron 0 between 400 and 500 ms, neuron 35 is not in the raster
+	}
+	
+	/////Test that each point of a sweep gives the same spikes as a normal run with the same seed
+	////////////////////
+	TEST(TestSweep, SameAsOneRun) {
+		
+		Network net(42);
+		net.instaureConnections();
+		Sweep sweep(net.getConnectivity(), excitatoryNeurons, net.getSeed(), 2);
+		const std::vector<SweepPoint> points = {{3.0, 2.0}, {5.0, 2.0}, {4.5, 0.9}};
+		ASSERT_TRUE(sweep.run(points, 0, 200, 0.0));
+		
+		for(size_t p(0); p < points.size(); ++p) {
+			NeuronPopulation& population(net.getPopulation()); //the network is used again for each point
+			population = NeuronPopulation(totalN, excitatoryNeurons, 42);
+			population.setG(points[p].g);
+			population.setEtha(points[p].etha);
+			population.setConnectivity(net.getConnectivity());
+			SpikeAnalysis analysis(totalN, excitatoryNeurons, 0, 200);
+			Simulation(population, 1).run(0, 200, 0.0, [&](unsigned long n, const std::vector<uint32_t>& s) { analysis.record(n, s); });
+			
+			EXPECT_GT(analysis.getTotalSpikes(), 0);
+			EXPECT_EQ(sweep.getAnalysis(p).getTotalSpikes(), analysis.getTotalSpikes());
+			EXPECT_EQ(sweep.getAnalysis(p).getHistogram(), analysis.getHistogram());
+		}
+		EXPECT_EQ(Sweep::prefix(points[2]), "g4.5_etha0.9_");
+	}
+	
+	/////Test that the procedural targets don't depend on the ranges and have the expected number of connections
+	////////////////////
+	TEST(TestProceduralConnectivity, Targets) {
+		
+		ProceduralConnectivity connectivity(totalN, excitatoryNeurons, excitatoryConnections, inhibitoryConnections, 42);
+		std::vector<unsigned long> inDegree(totalN, 0);
+		for(unsigned long i(0); i < totalN; ++i) {
+			std::vector<uint32_t> all, ranges;
+			connectivity.forEachTarget(i, 0, totalN, [&](uint32_t t) { all.push_back(t); });
+			for(unsigned long first(0); first < totalN; first += 3*blockSize) { //ranges of threads
+				connectivity.forEachTarget(i, first, first+3*blockSize, [&](uint32_t t) { ranges.push_back(t); });
+			}
+			ASSERT_EQ(all, ranges);
+			ASSERT_TRUE(std::adjacent_find(all.begin(), all.end(), std::greater_equal<uint32_t>()) == all.end()); //increasing
+			for(auto t : all) {
+				++inDegree[t];
+			}
+		}
+		double mean(0.0);
+		for(auto k : inDegree) {
+			mean += k;
+		}
+		mean /= totalN;
+		EXPECT_NEAR(mean, excitatoryConnections+inhibitoryConnections, 2.0);
+		EXPECT_NEAR(connectivity.getProbability(0), 0.1, 1e-12);
+		
+		//the simulation gives the same spikes with one or several threads
+		Network net1(42), net2(42);
+		for(auto net : {&net1, &net2}) {
+			net->getPopulation().setG(5.0);
+			net->getPopulation().setEtha(2.0);
+			net->instaureProceduralConnections();
+		}
+		EXPECT_EQ(net1.getConnectivity().getNumberConnections(), 0);
+		std::vector<std::vector<uint32_t> > spikes1, spikes2;
+		Simulation(net1.getPopulation(), 1).run(0, 200, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { spikes1.push_back(s); });
+		Simulation(net2.getPopulation(), 3).run(0, 200, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { spikes2.push_back(s); });
+		EXPECT_EQ(spikes1, spikes2);
+	}
+	
+	/////Test the size of the network given by the parameters, and a network of another size
+	////////////////////
+	TEST(TestConfiguration, NetworkSize) {
+		
+		{
+			std::ofstream file("test_configuration.txt");
+			file << "# small network\nneurons = 1000\nconnection_probability = 0.05 # 40 and 10 connections\ng=5\n";
+		}
+		Configuration configuration;
+		ASSERT_TRUE(configuration.read("test_configuration.txt"));
+		EXPECT_TRUE(configuration.set("inhibitory_connections=20"));
+		EXPECT_FALSE(configuration.set("neuron=10")); //unknown key
+		EXPECT_FALSE(configuration.set("etha=abc")); //the numbers are checked, the value is not kept
+		EXPECT_FALSE(configuration.set("etha=-1"));
+		EXPECT_FALSE(configuration.set("g=5x"));
+		EXPECT_FALSE(configuration.set("threads=-2"));
+		EXPECT_FALSE(configuration.set("steps=99999999999999999999999"));
+		EXPECT_TRUE(configuration.set("etha=2e0"));
+		EXPECT_EQ(configuration.getDouble("g"), 5.0);
+		EXPECT_EQ(configuration.getDouble("etha"), 2.0);
+		EXPECT_FALSE(configuration.has("threads"));
+		
+		NetworkSize size;
+		ASSERT_TRUE(configuration.getNetworkSize(size));
+		EXPECT_EQ(size.excitatory, 800);
+		EXPECT_EQ(size.inhibitory, 200);
+		EXPECT_EQ(size.excitatoryConnections, 40);
+		EXPECT_EQ(size.inhibitoryConnections, 20);
+		EXPECT_TRUE(configuration.set("excitatory_connections=900"));
+		EXPECT_FALSE(configuration.getNetworkSize(size)); //more connections than excitatory neurons
+		
+		Network net(NetworkSize{800, 200, 40, 20}, 42);
+		net.initializeNetwork(5.0, 4.0);
+		net.instaureConnections();
+		const Connectivity& connections(net.getConnectivity());
+		EXPECT_EQ(net.getPopulation().size(), 1000);
+		EXPECT_EQ(connections.getNumberConnections(), 1000*60);
+		std::vector<unsigned long> excitatory(1000, 0), inhibitory(1000, 0);
+		for(unsigned long i(0); i < 1000; ++i) {
+			for(const uint32_t* target(connections.beginTargets(i)); target != connections.endTargets(i); ++target) {
+				++(i < 800 ? excitatory : inhibitory)[*target];
+			}
+		}
+		for(unsigned long n(0); n < 1000; ++n) { //each neuron receives the connections of the size
+			ASSERT_EQ(excitatory[n], 40);
+			ASSERT_EQ(inhibitory[n], 20);
+		}
+	}
+	
+	/////Test that the processes sharing the neurons give the same spikes as a single one
+	////////////////////
+	TEST(TestSpikeTransport, SameAsOneProcess) {
+		
+		Network net1(42);
+		net1.initializeNetwork(5.0, 2.0);
+		net1.instaureConnections();
+		std::vector<std::vector<uint32_t> > expected;
+		Simulation(net1.getPopulation(), 1).run(0, 200, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { expected.push_back(s); });
+		
+		Network net2(42);
+		net2.initializeNetwork(5.0, 2.0);
+		SharedMemoryTransport transport(3, totalN*D+D);
+		ASSERT_TRUE(transport.spawn());
+		const unsigned long first(Simulation::partition(totalN, transport.getRank(), 3));
+		const unsigned long last(Simulation::partition(totalN, transport.getRank()+1, 3));
+		net2.instaureConnections(first, last); //each process only has the connections towards its neurons
+		
+		std::vector<std::vector<uint32_t> > spikes;
+		const bool success(Simulation(net2.getPopulation(), 2, &transport).run(0, 200, 0.0,
+						   [&](unsigned long, const std::vector<uint32_t>& s) { spikes.push_back(s); }));
+		if(transport.getRank() != 0) { //the other processes stop there
+			_exit((success and spikes == expected) ? 0 : 1);
+		}
+		EXPECT_TRUE(success);
+		EXPECT_LT(net2.getConnectivity().getNumberConnections(), net1.getConnectivity().getNumberConnections()/2);
+		EXPECT_EQ(spikes, expected);
+		EXPECT_TRUE(transport.wait()); //the other processes received the same spikes
+	}
+	
+	/////Test that an error of one process makes all the processes fail instead of waiting
+	////////////////////
+	TEST(TestSpikeTransport, FailTogether) {
+		
+		//too many spikes in the process 1: all the processes fail at the same exchange
+		SharedMemoryTransport transport(3, 4);
+		ASSERT_TRUE(transport.spawn());
+		std::vector<std::vector<uint32_t> > all;
+		const bool first(transport.exchange(std::vector<uint32_t>(transport.getRank() == 1 ? 5 : 4, 1), all));
+		if(transport.getRank() != 0) {
+			_exit(first ? 1 : 0);
+		}
+		EXPECT_FALSE(first);
+		EXPECT_TRUE(transport.wait());
+		
+		//the process 1 ends before the exchange: the process 0 doesn't wait for it
+		SharedMemoryTransport broken(2, 4);
+		ASSERT_TRUE(broken.spawn());
+		if(broken.getRank() != 0) {
+			_exit(0);
+		}
+		EXPECT_FALSE(broken.exchange(std::vector<uint32_t>(1, 1), all));
+		EXPECT_TRUE(broken.wait());
+	}
+	
+	/////Test that a simulation restored from a checkpoint continues with the same spikes
+	////////////////////
+	TEST(TestCheckpoint, SameSpikes) {
+		
+		Network net(42);
+		net.initializeNetwork(5.0, 2.0);
+		net.instaureConnections();
+		std::vector<std::vector<uint32_t> > expected, spikes;
+		Simulation simulation(net.getPopulation(), 2);
+		simulation.run(0, 150, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { expected.push_back(s); });
+		ASSERT_TRUE(net.save("test_checkpoint.chk", 150));
+		simulation.run(150, 300, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { expected.push_back(s); });
+		spikes.assign(expected.begin(), expected.begin()+150);
+		
+		NetworkSize size;
+		unsigned int seed(0);
+		ASSERT_TRUE(Network::readCheckpoint("test_checkpoint.chk", size, seed));
+		EXPECT_EQ(seed, 42);
+		EXPECT_EQ(size.total(), totalN);
+		for(bool mapped : {true, false}) {
+			Network restored(size, seed);
+			unsigned long step(0);
+			ASSERT_TRUE(restored.restore("test_checkpoint.chk", step, mapped));
+			EXPECT_EQ(step, 150);
+			EXPECT_EQ(restored.getPopulation().getG(), 5.0);
+			EXPECT_EQ(restored.getConnectivity().getNumberConnections(), net.getConnectivity().getNumberConnections());
+			EXPECT_EQ(restored.getConnectivity().getMemory() == 0, mapped); //the connections are in the file
+			
+			std::vector<std::vector<uint32_t> > continued(spikes);
+			Simulation(restored.getPopulation(), 3).run(step, 300, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) { continued.push_back(s); });
+			EXPECT_EQ(continued, expected);
+		}
+		unsigned long step(0);
+		EXPECT_FALSE(Network(NetworkSize{800, 200, 80, 20}, 42).restore("test_checkpoint.chk", step)); //another size
+	}
+	
+	/////Test that the counters of the instrumentation follow the simulation and are written in the snapshots
+	////////////////////
+	TEST(TestInstrumentation, Snapshot) {
+		
+		Network net(42);
+		net.initializeNetwork(5.0, 2.0);
+		net.instaureConnections();
+		Instrumentation& instrumentation(Instrumentation::global());
+		instrumentation.reset();
+		unsigned long spikes(0), events(0);
+		Simulation(net.getPopulation(), 2).run(0, 300, 0.0, [&](unsigned long, const std::vector<uint32_t>& s) {
+			spikes += s.size();
+			for(auto i : s) {
+				events += net.getConnectivity().getNumberTargets(i);
+			}
+		});
+		if(instrumentationEnabled) {
+			EXPECT_EQ(instrumentation.getCount(STEPS_COUNTER), 300);
+			EXPECT_EQ(instrumentation.getCount(SPIKES_COUNTER), spikes);
+			EXPECT_EQ(instrumentation.getCount(EVENTS_COUNTER), events);
+			EXPECT_GT(instrumentation.getSeconds(MEMBRANE_PHASE), 0.0);
+		} else { //nothing is measured
+			EXPECT_EQ(instrumentation.getCount(SPIKES_COUNTER), 0);
+		}
+		
+		instrumentation.add(BYTES_COUNTER, 1234);
+		ASSERT_TRUE(instrumentation.snapshot("test_metrics.prom", PROMETHEUS_METRICS, 300));
+		std::ifstream prometheus("test_metrics.prom");
+		std::stringstream text;
+		text << prometheus.rdbuf();
+		EXPECT_NE(text.str().find("brunel_step 300\n"), std::string::npos);
+		EXPECT_NE(text.str().find("brunel_bytes_written_total " + std::to_string(instrumentation.getCount(BYTES_COUNTER)) + "\n"), std::string::npos);
+		EXPECT_NE(text.str().find("brunel_phase_seconds_total{phase=\"delivery\"}"), std::string::npos);
+		
+		std::ostringstream json;
+		instrumentation.writeJson(json, 300);
+		EXPECT_EQ(json.str().find("{\"step\": 300,"), 0);
+		EXPECT_NE(json.str().find("\"spikes\": " + std::to_string(instrumentation.getCount(SPIKES_COUNTER))), std::string::npos);
 	}
 	
 }
@@ -0,0 +1,250 @@
+#include "Plasticity.hpp"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace {
+
+//decay of a trace after each number of steps, until it is negligible (10 time constants)
+vector<double> decayTable(double tau)
+{
+	vector<double> decay(static_cast<unsigned long>(ceil(10.0*tau/h))+1);
+	for(unsigned long k(0); k < decay.size(); ++k) {
+		decay[k] = exp(-(k*h)/tau);
+	}
+	return decay;
+}
+
+}
+
+Plasticity::Plasticity(const Connectivity& connections, const vector<NeuronGroup>& groups, const StdpParameters& parameters)
+	:connections(connections), parameters(parameters), potentiation(parameters.potentiation*J_excitatory),
+	 depression(parameters.depression*J_excitatory), maxWeight(parameters.maxWeight*J_excitatory),
+	 plastic(connections.size(), 0), weights(connections.getNumberConnections(), 0.0f),
+	 decayPlus(decayTable(parameters.tauPlus)), decayMinus(decayTable(parameters.tauMinus)), historySize(1),
+	 postTraces(connections.size(), {0.0, -1, -1}), postCount(connections.size(), 0), bounds({0, connections.size()}),
+	 parts(1, {vector<Trace>(connections.size(), {0.0, -1, -1}), vector<vector<uint32_t> >(decayPlus.size()), -1})
+{
+	assert(parameters.tauPlus > 0.0 and parameters.tauMinus > 0.0 and parameters.maxWeight >= 0.0);
+	const unsigned long size(connections.size());
+	const uint32_t* base(connections.beginTargets(0));
+
+	//the synapses of the excitatory groups start at the amplitude of their group
+	unsigned long i(0);
+	int refractory(numeric_limits<int>::max());
+	for(const auto& group : groups) {
+		for(unsigned long end(min(size, i+group.size)); i < end; ++i) {
+			if(group.weight > 0.0) {
+				plastic[i] = 1;
+				fill(weights.begin()+(connections.beginTargets(i)-base), weights.begin()+(connections.endTargets(i)-base),
+					 static_cast<float>(min(group.weight*J_excitatory, double(maxWeight))));
+			}
+		}
+		refractory = min(refractory, group.refractory);
+	}
+
+	//two post spikes of a neuron are at least a refractory period apart
+	while(historySize < decayPlus.size()/max(1, refractory)+1) {
+		historySize *= 2;
+	}
+	postSpikes.assign(size*historySize, -1);
+}
+
+void Plasticity::setPartition(const vector<unsigned long>& partition)
+{
+	assert(partition.size() >= 2 and partition.back() <= connections.size());
+	//the empty ranges (more threads than blocks) have no part, each part is only written by one thread
+	bounds = partition;
+	bounds.erase(unique(bounds.begin(), bounds.end()), bounds.end());
+	if(bounds.size() < 2) {
+		bounds.push_back(bounds.front());
+	}
+	const Part part(parts.front()); //the copies are the same between two steps
+	parts.assign(bounds.size()-1, part);
+}
+
+double Plasticity::read(const Trace& trace, const vector<double>& decay, long step)
+{
+	//the spike of the step is not counted yet, so the spikes of a step can come in any order
+	const unsigned long elapsed(step-trace.step);
+	if(trace.step < 0 or elapsed >= decay.size()) {
+		return 0.0;
+	}
+	return elapsed == 0 ? trace.value : (trace.value+1.0)*decay[elapsed];
+}
+
+float Plasticity::potentiate(float weight, const Trace& pre, uint32_t j, long step) const
+{
+	const Trace& post(postTraces[j]);
+	if(pre.step < 0 or post.step < pre.step) { //no post spike since the pre spike
+		return weight;
+	}
+	if(post.previous < pre.step) { //only the last one, without reading the other post spikes
+		if(post.step < step) {
+			weight = min(maxWeight, weight+potentiation*static_cast<float>(read(pre, decayPlus, post.step)));
+		}
+		return weight;
+	}
+	//the post spikes of j from the pre spike to the step (excluded), the last ones are at the end
+	const int32_t* spikes(&postSpikes[j*historySize]);
+	const uint32_t count(postCount[j]);
+	unsigned long n(0);
+	while(n < historySize and n < count and spikes[(count-1-n)&(historySize-1)] >= pre.step) {
+		++n;
+	}
+	for(; n > 0; --n) {
+		const long post(spikes[(count-n)&(historySize-1)]);
+		if(post < step) {
+			weight = min(maxWeight, weight+potentiation*static_cast<float>(read(pre, decayPlus, post)));
+		}
+	}
+	return weight;
+}
+
+void Plasticity::closeWindows(Part& part, unsigned long first, unsigned long last, unsigned long step)
+{
+	const uint32_t* base(connections.beginTargets(0));
+	const long window(decayPlus.size());
+	//a slot has the sources of the step one window before, each slot is read once if the steps jump further
+	for(long n(max(part.lastStep+1, static_cast<long>(step)-window+1)); n <= static_cast<long>(step); ++n) {
+		vector<uint32_t>& sources(part.recent[n%window]);
+		for(auto i : sources) {
+			Trace& pre(part.preTraces[i]);
+			if(pre.step < 0 or n-pre.step < window) { //it has spiked again
+				continue;
+			}
+			const uint32_t* begin(lower_bound(connections.beginTargets(i), connections.endTargets(i), first));
+			const uint32_t* end(lower_bound(begin, connections.endTargets(i), last));
+			float* weight(&weights[begin-base]);
+			for(const uint32_t* t(begin); t != end; ++t, ++weight) {
+				*weight = potentiate(*weight, pre, *t, n);
+			}
+			pre.step = -1; //its trace is 0 now
+		}
+		sources.clear();
+	}
+	part.lastStep = step;
+}
+
+template<typename Real>
+uint64_t Plasticity::deliver(unsigned long step, const vector<uint32_t>& sources, unsigned long first, unsigned long last,
+							 Real* input, const vector<uint8_t>& group, const vector<double>& amplitude)
+{
+	if(first == last) { //an empty range has no target, and no part
+		return 0;
+	}
+	const unsigned long p(upper_bound(bounds.begin(), bounds.end(), first)-bounds.begin()-1);
+	assert(p+1 < bounds.size() and last <= bounds[p+1]);
+	Part& part(parts[p]);
+	if(static_cast<long>(step) != part.lastStep) { //the spikes of a step can be delivered in several calls
+		assert(static_cast<long>(step) > part.lastStep);
+		closeWindows(part, bounds[p], bounds[p+1], step);
+	}
+	const uint32_t* base(connections.beginTargets(0));
+	uint64_t events(0);
+
+	//the pre spikes potentiate their synapses, are transmitted with the weights, then depress the synapses
+	for(auto i : sources) {
+		const uint32_t* begin(lower_bound(connections.beginTargets(i), connections.endTargets(i), first));
+		const uint32_t* end(lower_bound(begin, connections.endTargets(i), last));
+		events += end-begin;
+		if(!plastic[i]) {
+			const Real J(amplitude[group[i]]);
+			for(const uint32_t* t(begin); t != end; ++t) {
+				input[*t] += J;
+			}
+			continue;
+		}
+		const Trace& pre(part.preTraces[i]);
+		float* weight(&weights[begin-base]);
+		for(const uint32_t* t(begin); t != end; ++t, ++weight) {
+			const Trace& post(postTraces[*t]);
+			//the post spikes are only looked for if the target has spiked since the pre spike
+			const float w(post.step >= pre.step and pre.step >= 0 ? potentiate(*weight, pre, *t, step) : *weight);
+			input[*t] += Real(w);
+			*weight = max(0.0f, w-depression*static_cast<float>(read(post, decayMinus, step)));
+		}
+	}
+
+	//the post spikes of the range are kept for the next pre spikes
+	for(auto j(lower_bound(sources.begin(), sources.end(), first)); j != sources.end() and *j < last; ++j) {
+		postTraces[*j] = {read(postTraces[*j], decayMinus, step), static_cast<int32_t>(step), postTraces[*j].step};
+		postSpikes[*j*historySize + (postCount[*j]&(historySize-1))] = step;
+		++postCount[*j];
+	}
+
+	//each range follows all the pre spikes
+	vector<uint32_t>& recent(part.recent[step%decayPlus.size()]);
+	for(auto i : sources) {
+		if(plastic[i]) {
+			part.preTraces[i] = {read(part.preTraces[i], decayPlus, step), static_cast<int32_t>(step), -1};
+			recent.push_back(i);
+		}
+	}
+	return events;
+}
+
+////////////////GETTERS//////////////////////
+
+vector<float> Plasticity::getWeights() const
+{
+	//the synapses of each range get the potentiation of the post spikes since the last pre spike
+	vector<float> current(weights);
+	const uint32_t* base(connections.beginTargets(0));
+	for(size_t p(0); p < parts.size(); ++p) {
+		for(unsigned long i(0); i < connections.size(); ++i) {
+			if(!plastic[i]) {
+				continue;
+			}
+			const uint32_t* begin(lower_bound(connections.beginTargets(i), connections.endTargets(i), bounds[p]));
+			const uint32_t* end(lower_bound(begin, connections.endTargets(i), bounds[p+1]));
+			for(const uint32_t* t(begin); t != end; ++t) {
+				current[t-base] = potentiate(current[t-base], parts[p].preTraces[i], *t, parts[p].lastStep+1);
+			}
+		}
+	}
+	return current;
+}
+
+double Plasticity::getMeanWeight() const
+{
+	const vector<float> current(getWeights());
+	const uint32_t* base(connections.beginTargets(0));
+	double total(0.0);
+	unsigned long number(0);
+	for(unsigned long i(0); i < connections.size(); ++i) {
+		if(plastic[i]) {
+			for(const uint32_t* t(connections.beginTargets(i)); t != connections.endTargets(i); ++t) {
+				total += current[t-base];
+			}
+			number += connections.getNumberTargets(i);
+		}
+	}
+	return number == 0 ? 0.0 : total/number;
+}
+
+const StdpParameters& Plasticity::getParameters() const
+{
+	return parameters;
+}
+
+unsigned long Plasticity::getMemory() const
+{
+	unsigned long recent(0);
+	for(auto const& part : parts) {
+		for(auto const& sources : part.recent) {
+			recent += sources.capacity()*sizeof(uint32_t);
+		}
+	}
+	return weights.size()*sizeof(float) + plastic.size() + postTraces.size()*sizeof(Trace)
+		   + postSpikes.size()*sizeof(int32_t) + postCount.size()*sizeof(uint32_t)
+		   + parts.size()*connections.size()*sizeof(Trace) + recent;
+}
+
+template uint64_t Plasticity::deliver<double>(unsigned long, const vector<uint32_t>&, unsigned long, unsigned long, double*,
+											  const vector<uint8_t>&, const vector<double>&);
+template uint64_t Plasticity::deliver<float>(unsigned long, const vector<uint32_t>&, unsigned long, unsigned long, float*,
+											 const vector<uint8_t>&, const vector<double>&);
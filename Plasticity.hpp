@@ -0,0 +1,167 @@
+#ifndef PLASTICITY_HPP
+#define PLASTICITY_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "Neuron.hpp"
+#include "NeuronGroup.hpp"
+#include "Connectivity.hpp"
+
+/*!
+ * @file Plasticity.hpp
+ * parameters of the spike-timing-dependent plasticity, the amplitudes are in units of J_excitatory
+ */
+struct StdpParameters {
+	double potentiation; //!< increase of a weight for a post spike just after a pre spike
+	double depression; //!< decrease of a weight for a pre spike just after a post spike
+	double tauPlus; //!< time constant of the traces of the pre spikes (ms)
+	double tauMinus; //!< time constant of the traces of the post spikes (ms)
+	double maxWeight; //!< largest weight of a synapse
+};
+
+const StdpParameters defaultStdp = {0.01, 0.0105, 20.0, 20.0, 2.0}; //!< depression slightly stronger than potentiation
+
+/*!
+ * @class Plasticity
+ * Class that gives a weight to each synapse of the excitatory neurons and changes it with the time between the
+ * spikes of its source (pre) and of its target (post), by pairs of spikes with exponential traces: a pre spike
+ * transmits the weight of the synapse, then decreases it by the depression times the post trace of the target;
+ * a post spike increases the weight of each synapse it receives by the potentiation times the pre trace of the
+ * source. The pairs of spikes at the same step are not counted and the weights stay between 0 and maxWeight.
+ * Nothing is done at the steps without spikes: a trace keeps its value at the last spike and the step of this
+ * spike, its decay is read in a table until it is negligible (10 time constants, the window).
+ *
+ * The weights are in the order of the targets of the Connectivity, so a pre spike reads its weights in one block
+ * with its targets. The potentiation is not made at the post spike, which would write in synapses all over the
+ * weights, but at the next pre spike of the synapse: each neuron keeps the steps of its post spikes of the window,
+ * and a pre spike first adds the potentiation of the post spikes of its targets since its last spike, in their
+ * order, then transmits the weight. The weight of each synapse goes through the same operations as if each post
+ * spike had changed it at once. The post trace of a neuron has its two last spikes, which are read with the
+ * depression anyway, so the other ones are only read when it has spiked more than twice since the pre spike.
+ * A neuron which doesn't spike again during the window gets the potentiation of its synapses at the end of the
+ * window. It takes 4 bytes per synapse and a few hundred bytes per neuron.
+ * The synapses of the inhibitory neurons keep the amplitude of their group, given by g.
+ *
+ * The delivery is shared between threads by ranges of targets: a range owns the weights, the post traces and the
+ * post spikes of its targets. Each range has its own copy of the pre traces, updated with all the spikes of each
+ * step, so the threads never write in the same place and the results are the same whatever the number of threads.
+ */
+
+class Plasticity {
+
+	public:
+
+	/*!
+     * Constructor of the class Plasticity
+     * @param connections: the stored connections of the network, they are not copied
+     * @param groups: the groups of the neurons, the synapses of the excitatory groups are plastic and start at
+     * the amplitude of their group
+     * @param parameters: the amplitudes and the time constants of the plasticity
+     */
+	Plasticity(const Connectivity& connections, const std::vector<NeuronGroup>& groups, const StdpParameters& parameters = defaultStdp);
+
+	/*!
+	 * @param bounds: the first neuron of each range of targets, and the end of the last range
+	 * Shares the delivery between ranges (the threads of a simulation), each one gets a copy of the pre traces
+	 * of the first range; the empty ranges are left out
+     */
+	void setPartition(const std::vector<unsigned long>& bounds);
+
+	/*!
+	 * @param step: the simulation time of the spikes, the steps come in increasing order
+	 * @param sources: the neurons which spiked, in increasing order
+	 * @param first, last: the range of targets, inside one range of the partition, nothing is done if it is empty
+	 * @param input: the ring buffer slot which receives the spikes
+	 * @param group, amplitude: the group of each neuron and the amplitude of each group, for the static synapses
+	 * Delivers the spikes of a step to the targets of the range with their weights, after their potentiation,
+	 * then depresses them, and keeps the post spikes of the range and the pre traces
+	 * @return the number of synaptic events delivered
+     */
+	template<typename Real>
+	uint64_t deliver(unsigned long step, const std::vector<uint32_t>& sources, unsigned long first, unsigned long last,
+					 Real* input, const std::vector<uint8_t>& group, const std::vector<double>& amplitude);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Computes the weights of the synapses with the potentiations which are not made yet
+	 * @return the weight of each synapse in the order of the targets, 0 for the static synapses
+     */
+	std::vector<float> getWeights() const;
+
+	/*!
+	 * Computes the mean weight of the plastic synapses
+	 * @return the mean weight (mV), 0 without plastic synapse
+     */
+	double getMeanWeight() const;
+
+	/*!
+	 * Getter for the parameters of the plasticity
+	 * @return parameters
+     */
+	const StdpParameters& getParameters() const;
+
+	/*!
+	 * Getter for the memory used by the weights, the traces and the post spikes
+	 * @return the number of bytes
+     */
+	unsigned long getMemory() const;
+
+	private:
+
+	/*!
+	 * trace of the spikes of a neuron: its value just before the last spike, at the step of this spike
+	 */
+	struct Trace {
+		double value; //!< value of the trace just before the last spike, the spike adds 1 after its step
+		int32_t step; //!< step of the last spike, -1 if there is none in the window
+		int32_t previous; //!< step of the spike before, -1 if there is none, only for the post spikes
+	};
+
+	/*!
+	 * state of a range of targets
+	 */
+	struct Part {
+		std::vector<Trace> preTraces; //!< traces of the pre spikes of all the neurons
+		std::vector<std::vector<uint32_t> > recent; //!< plastic sources of the steps of the window, by step modulo the window
+		long lastStep; //!< last step delivered
+	};
+
+	/*!
+	 * @param trace: the trace of a neuron; decay: the table of the decay; step: a step after the last spike
+	 * @return the value of the trace at the step, before its spikes of the step
+     */
+	static double read(const Trace& trace, const std::vector<double>& decay, long step);
+
+	/*!
+	 * @param weight: the weight of a synapse; pre: the trace of its source; j: its target
+	 * @param step: the post spikes before this step are counted
+	 * @return the weight increased by the post spikes of j since the last pre spike, in their order
+     */
+	float potentiate(float weight, const Trace& pre, uint32_t j, long step) const;
+
+	/*!
+	 * @param part: the range of targets; first, last: its bounds; step: the next step delivered
+	 * Potentiates the synapses of the sources whose window has ended since the last step delivered
+     */
+	void closeWindows(Part& part, unsigned long first, unsigned long last, unsigned long step);
+
+	const Connectivity& connections; //!< targets of each neuron
+	StdpParameters parameters; //!< amplitudes and time constants
+	float potentiation; //!< increase of a weight for a pre trace of 1 (mV)
+	float depression; //!< decrease of a weight for a post trace of 1 (mV)
+	float maxWeight; //!< largest weight (mV)
+	std::vector<uint8_t> plastic; //!< 1 if the synapses of the neuron are plastic
+	std::vector<float> weights; //!< weight of each synapse, in the order of the targets
+	std::vector<double> decayPlus; //!< decay of a pre trace after each number of steps, its size is the window
+	std::vector<double> decayMinus; //!< decay of a post trace after each number of steps
+	unsigned long historySize; //!< number of post spikes kept for each neuron, a power of 2 enough for the window
+	std::vector<Trace> postTraces; //!< traces of the post spikes of each neuron with its two last post spikes, written by the range of the neuron
+	std::vector<int32_t> postSpikes; //!< steps of the last post spikes of each neuron, historySize per neuron
+	std::vector<uint32_t> postCount; //!< number of post spikes of each neuron, the next one goes at this position modulo historySize
+	std::vector<unsigned long> bounds; //!< first neuron of each range of targets, and the end of the last range
+	std::vector<Part> parts; //!< state of each range of targets
+
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "PoissonSampler.hpp"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+constexpr uint64_t scale(uint64_t(1) << 32); //!< the thresholds are probabilities times 2^32
+constexpr int guideBits(8); //!< number of highest bits of u used to index the guide table
+constexpr unsigned long lanes(8); //!< number of groups of 4 neurons computed together by fill
+
+PoissonSampler::PoissonSampler(double rate, uint64_t seed)
+	:random(seed), lambda(rate), guide(1 << guideBits, 0)
+{
+	assert(rate >= 0.0);
+	
+	//cumulative distribution until the rest of the probability is too small to be seen with 32 bits
+	double probability(exp(-lambda)); //P(X = 0)
+	double sum(probability);
+	for(int k(0); ; ++k) {
+		const uint64_t threshold(min<uint64_t>(scale, llround(sum*scale)));
+		cumulative.push_back(threshold);
+		if(threshold == scale or (k > lambda and probability*scale < 0.5)) {
+			break;
+		}
+		probability *= lambda/(k+1);
+		sum += probability;
+	}
+	cumulative.back() = scale; //the search always stops at the last value
+	
+	//for each value of the highest bits, the first k which can be the result
+	size_t k(0);
+	for(size_t g(0); g < guide.size(); ++g) {
+		const uint64_t lowest(static_cast<uint64_t>(g) << (32-guideBits));
+		while(lowest >= cumulative[k]) {
+			++k;
+		}
+		guide[g] = k;
+	}
+}
+
+double PoissonSampler::getLambda() const
+{
+	return lambda;
+}
+
+uint64_t PoissonSampler::getSeed() const
+{
+	return random.getSeed();
+}
+
+int PoissonSampler::lookup(uint32_t u) const
+{
+	int k(guide[u >> (32-guideBits)]);
+	while(u >= cumulative[k]) {
+		++k;
+	}
+	return k;
+}
+
+int PoissonSampler::sample(uint64_t i, uint64_t step) const
+{
+	return lookup(random(i/4, step)[i%4]);
+}
+
+template<typename Real>
+void PoissonSampler::fill(Real* noise, uint64_t first, unsigned long count, uint64_t step, double amplitude) const
+{
+	uint32_t words[4*lanes];
+	const uint64_t end(first+count);
+	
+	for(uint64_t group(first/4); 4*group < end; group += lanes) {
+		const unsigned long groups(min<uint64_t>(lanes, (end+3)/4 - group));
+		random.fill(words, group, groups, step); //4 words for each group of 4 neurons
+		
+		for(size_t w(0); w < 4*groups; ++w) {
+			const uint64_t i(4*group + w);
+			if(i >= first and i < end) {
+				noise[i-first] = lookup(words[w])*amplitude;
+			}
+		}
+	}
+}
+
+template<typename Real>
+void PoissonSampler::fill(Real* noise, uint64_t first, unsigned long count, uint64_t step, double amplitude,
+						  const uint16_t* active, unsigned long number) const
+{
+	uint32_t words[4*lanes];
+	const uint64_t end(first+count);
+	unsigned long a(0); //next active neuron
+
+	for(uint64_t group(first/4); a < number; group += lanes) {
+		const uint64_t groupsEnd(min<uint64_t>(4*(group+lanes), end)); //end of the neurons of the 8 groups
+		if(first+active[a] >= groupsEnd) { //no active neuron in these groups
+			continue;
+		}
+		random.fill(words, group, min<uint64_t>(lanes, (end+3)/4 - group), step);
+
+		for(; a < number and first+active[a] < groupsEnd; ++a) {
+			assert(active[a] < count and (a == 0 or active[a-1] < active[a]));
+			noise[active[a]] = lookup(words[first+active[a] - 4*group])*amplitude;
+		}
+	}
+}
+
+template void PoissonSampler::fill<double>(double*, uint64_t, unsigned long, uint64_t, double) const;
+template void PoissonSampler::fill<float>(float*, uint64_t, unsigned long, uint64_t, double) const;
+template void PoissonSampler::fill<double>(double*, uint64_t, unsigned long, uint64_t, double, const uint16_t*, unsigned long) const;
+template void PoissonSampler::fill<float>(float*, uint64_t, unsigned long, uint64_t, double, const uint16_t*, unsigned long) const;
@@ -0,0 +1,88 @@
+#ifndef POISSONSAMPLER_HPP
+#define POISSONSAMPLER_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "CounterRandom.hpp"
+
+/*!
+ * @class PoissonSampler
+ * Class that draws the random spikes coming from the rest of the brain, for a fixed rate lambda.
+ * The cumulative distribution of the Poisson law is computed once in a table of 32 bits thresholds,
+ * a random integer of 32 bits is then turned into a number of spikes by a lookup in this table
+ * (a guide table gives where to start the search, so it takes one or two comparisons).
+ * The integers come from the counter based generator: the 4 words of Philox at (i/4, step) are used
+ * by the neurons 4*(i/4) to 4*(i/4)+3, so one call gives the spikes of 4 neurons and a neuron always gets
+ * the same number at a given step, whatever the order of the calls.
+ */
+
+class PoissonSampler {
+
+	public:
+
+	/*!
+     * Constructor of the class PoissonSampler
+     * @param rate: the mean number of spikes per step (lambda); seed: the seed of the generator
+     */
+	PoissonSampler(double rate = 0.0, uint64_t seed = 0);
+
+	/*!
+	 * Getter for the mean number of spikes per step
+	 * @return lambda
+     */
+	double getLambda() const;
+
+	/*!
+	 * Getter for the seed of the generator
+	 * @return the seed of random
+     */
+	uint64_t getSeed() const;
+
+	/*!
+	 * @param i: the index of the neuron; step: the time of the reception
+	 * Draws the number of spikes received by the neuron i at this step
+	 * @return a number following the Poisson distribution of mean lambda
+     */
+	int sample(uint64_t i, uint64_t step) const;
+
+	/*!
+	 * @param noise: array of count values which receives the spikes
+	 * @param first, count: the neurons from first to first+count (excluded) receive spikes
+	 * @param step: the time of the reception; amplitude: the value of one spike
+	 * Fills the array with the spikes of a range of neurons at a step, times the amplitude, in one call.
+	 * The random words are computed for 8 groups of 4 neurons at a time, so the compiler can vectorize Philox.
+	 * Real is double or float, the precision of the population.
+     */
+	template<typename Real>
+	void fill(Real* noise, uint64_t first, unsigned long count, uint64_t step, double amplitude) const;
+
+	/*!
+	 * @param noise, first, count, step, amplitude: the same as for fill
+	 * @param active, number: the positions in the range (from first) of the neurons which receive spikes, in
+	 * increasing order, and how many there are
+	 * Fills the array only at the positions of the active neurons, with the same values as fill, the others are
+	 * not written. The table is only searched for these neurons, and the random words of 8 groups of 4 neurons
+	 * are not computed if none of their neurons is active.
+     */
+	template<typename Real>
+	void fill(Real* noise, uint64_t first, unsigned long count, uint64_t step, double amplitude,
+			  const uint16_t* active, unsigned long number) const;
+
+	private:
+
+	/*!
+	 * @param u: a random integer of 32 bits
+	 * Inversion of the cumulative distribution with the tables
+	 * @return the first k such that u < cumulative[k]
+     */
+	int lookup(uint32_t u) const;
+
+	CounterRandom random; //!< generator of the random integers
+	double lambda; //!< mean number of spikes per step
+	std::vector<uint64_t> cumulative; //!< P(X <= k) times 2^32, the last value is 2^32
+	std::vector<uint16_t> guide; //!< first k to look at for each value of the 8 highest bits of u
+
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "ProceduralConnectivity.hpp"
+#include <iostream>
+#include <cassert>
+
+using namespace std;
+
+namespace {
+
+	/*!
+	 * @return log(1-p) for a probability p of connection, 0 if there is no connection
+     */
+	double logMissProbability(unsigned long inDegree, unsigned long sources)
+	{
+		if(sources == 0 or inDegree == 0) {
+			return 0.0;
+		}
+		assert(inDegree <= sources);
+		return log1p(-static_cast<double>(inDegree)/sources);
+	}
+
+}
+
+ProceduralConnectivity::ProceduralConnectivity(unsigned long size, unsigned long excitatory, unsigned long excitatoryInDegree,
+											   unsigned long inhibitoryInDegree, unsigned int seed)
+	:numberNeurons(size), numberExcitatory(excitatory),
+	 logExcitatory(logMissProbability(excitatoryInDegree, excitatory)),
+	 logInhibitory(logMissProbability(inhibitoryInDegree, size-excitatory)),
+	 random((static_cast<uint64_t>(1) << 32) | seed) //the random spikes use the key seed
+{
+	assert(excitatory <= size and size <= (static_cast<uint64_t>(1) << 32));
+}
+
+unsigned long ProceduralConnectivity::size() const
+{
+	return numberNeurons;
+}
+
+double ProceduralConnectivity::getProbability(unsigned long i) const
+{
+	return -expm1(i < numberExcitatory ? logExcitatory : logInhibitory);
+}
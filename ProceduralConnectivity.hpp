@@ -0,0 +1,98 @@
+#ifndef PROCEDURALCONNECTIVITY_HPP
+#define PROCEDURALCONNECTIVITY_HPP
+
+#include <iostream>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "CounterRandom.hpp"
+
+constexpr unsigned long targetBlockSize(256); //!< the targets are drawn by blocks of neurons, a range must start a block
+
+/*!
+ * @class ProceduralConnectivity
+ * Class that gives the targets of a neuron without storing them: they are drawn again each time the neuron spikes.
+ * Each neuron of the network is connected to each other neuron with a fixed probability, excitatoryConnections/
+ * excitatory for an excitatory source and inhibitoryConnections/inhibitory for an inhibitory one, so a neuron
+ * receives on average the same number of connections of each type as in the stored network (Bernoulli graph
+ * instead of a fixed in-degree, and no double connection).
+ * The targets of the source i in a block of targetBlockSize neurons only depend on the seed, i and the block
+ * (counter based generator), the distance to the next target follows a geometric law so only the targets are drawn.
+ * A thread which delivers to its own range of blocks draws only these blocks, with the same result as a single thread.
+ * It costs a few random numbers per target instead of 4 bytes of memory per connection.
+ */
+
+class ProceduralConnectivity {
+
+	public:
+
+	/*!
+     * Constructor of the class ProceduralConnectivity
+     * @param size: the number of neurons; excitatory: how many of them are excitatory (the first ones)
+     * @param excitatoryInDegree, inhibitoryInDegree: the mean number of connections received from each type
+     * @param seed: the seed of the connections
+     */
+	ProceduralConnectivity(unsigned long size = 0, unsigned long excitatory = 0, unsigned long excitatoryInDegree = 0,
+						   unsigned long inhibitoryInDegree = 0, unsigned int seed = 0);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Getter for the number of neurons of the network
+	 * @return numberNeurons
+     */
+	unsigned long size() const;
+
+	/*!
+	 * Getter for the probability of a connection from the neuron i to another neuron
+	 * @return the probability of the type of i
+     */
+	double getProbability(unsigned long i) const;
+
+	/*!
+	 * @param i: the index of the source; first, last: only the targets from first to last (excluded) are drawn,
+	 * first must start a block of targets
+	 * @param f: function called with the index of each target, in increasing order
+	 * Draws the targets of the neuron i in a range, block by block
+     */
+	template<typename Function>
+	void forEachTarget(unsigned long i, unsigned long first, unsigned long last, Function f) const;
+
+	private:
+
+	unsigned long numberNeurons; //!< number of neurons of the network
+	unsigned long numberExcitatory; //!< number of excitatory neurons, the first ones
+	double logExcitatory; //!< log(1-p) for an excitatory source, p being the probability of a connection
+	double logInhibitory; //!< log(1-p) for an inhibitory source
+	CounterRandom random; //!< generator of the connections, with a key different from the one of the random spikes
+
+};
+
+template<typename Function>
+void ProceduralConnectivity::forEachTarget(unsigned long i, unsigned long first, unsigned long last, Function f) const
+{
+	const double logMiss(i < numberExcitatory ? logExcitatory : logInhibitory);
+	if(logMiss == 0.0) { //no connection from this type of neuron
+		return;
+	}
+	const float inverseLog(1.0/logMiss); //the skips are small, single precision is enough and faster
+	last = std::min(last, numberNeurons);
+	for(unsigned long b(first); b < last; b += targetBlockSize) {
+		const unsigned long end(std::min(b+targetBlockSize, last));
+		const uint64_t stream((static_cast<uint64_t>(i) << 32) | (b/targetBlockSize));
+		//the distance to the next target is geometric: floor(log(u)/log(1-p)) neurons are skipped
+		unsigned long target(b);
+		for(uint64_t counter(0); target < end; ++counter) {
+			const std::array<uint32_t, 4> words(random(stream, counter));
+			for(size_t w(0); w < 4 and target < end; ++w) {
+				const float u((words[w]+0.5f)*(1.0f/4294967296.0f)); //in (0, 1)
+				target += static_cast<unsigned long>(std::log(u)*inverseLog);
+				if(target < end) {
+					f(static_cast<uint32_t>(target));
+					++target;
+				}
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include "Simulation.hpp"
+#include "Instrumentation.hpp"
+#include <iostream>
+#include <thread>
+#include <cassert>
+
+using namespace std;
+
+///////////////////////BARRIER////////////////////
+
+Barrier::Barrier(unsigned int count)
+	:numberThreads(count), waiting(0), generation(0)
+{}
+
+void Barrier::wait()
+{
+	unique_lock<mutex> lock(guard);
+	const unsigned long arrival(generation);
+	if(++waiting == numberThreads) { //the last thread wakes up the others
+		waiting = 0;
+		++generation;
+		condition.notify_all();
+	} else {
+		condition.wait(lock, [this, arrival] { return generation != arrival; });
+	}
+}
+
+///////////////////////SIMULATION////////////////////
+
+template<typename Real>
+BasicSimulation<Real>::BasicSimulation(BasicNeuronPopulation<Real>& neurons, unsigned int threads, SpikeTransport* spikeTransport)
+	:population(neurons), numberThreads(threads > 0 ? threads : 1), bounds(numberThreads+1, 0), spikes(numberThreads),
+	 sources(numberThreads), transport(spikeTransport), failed(false)
+{
+	//the range of this process, all the neurons without transport
+	const unsigned long first(transport ? partition(population.size(), transport->getRank(), transport->getProcesses()) : 0);
+	const unsigned long last(transport ? partition(population.size(), transport->getRank()+1, transport->getProcesses())
+									   : population.size());
+	//the blocks of the range are shared as equally as possible between the threads
+	for(size_t t(0); t <= numberThreads; ++t) {
+		bounds[t] = first+partition(last-first, t, numberThreads);
+	}
+}
+
+template<typename Real>
+unsigned long BasicSimulation<Real>::partition(unsigned long size, unsigned long part, unsigned long parts)
+{
+	const unsigned long numberBlocks((size+blockSize-1)/blockSize);
+	return min(size, ((numberBlocks*part)/parts)*blockSize);
+}
+
+template<typename Real>
+unsigned int BasicSimulation<Real>::getThreads() const
+{
+	return numberThreads;
+}
+
+template<typename Real>
+unsigned long BasicSimulation<Real>::getBound(unsigned int t) const
+{
+	return bounds[t];
+}
+
+template<typename Real>
+bool BasicSimulation<Real>::run(unsigned long start, unsigned long stop, double I, const Recorder& record)
+{
+	failed = false;
+	population.setPartition(bounds); //a copy of the pre traces for each thread
+	Barrier barrier(numberThreads);
+	vector<thread> threads;
+	for(size_t t(1); t < numberThreads; ++t) {
+		threads.push_back(thread(&BasicSimulation::work, this, t, start, stop, I, cref(record), ref(barrier)));
+	}
+	work(0, start, stop, I, record, barrier); //the calling thread is the thread 0
+
+	for(auto& th : threads) {
+		th.join();
+	}
+	population.setPartition({bounds.front(), bounds.back()}); //the range of the process is one range again
+	return !failed;
+}
+
+template<typename Real>
+void BasicSimulation<Real>::work(unsigned int t, unsigned long start, unsigned long stop, double I, const Recorder& record, Barrier& barrier)
+{
+	for(unsigned long epoch(start); epoch < stop; epoch += D) {
+		const unsigned long length(min<unsigned long>(D, stop-epoch)); //the last epoch can be shorter
+		
+		spikes[t].resize(length);
+		for(auto& list : spikes[t]) {
+			list.clear();
+		}
+		population.update(epoch, I, bounds[t], bounds[t+1], spikes[t]);
+		uint64_t threadSpikes(0);
+		for(auto const& list : spikes[t]) {
+			threadSpikes += list.size();
+		}
+		BRUNEL_COUNT(SPIKES_COUNTER, threadSpikes);
+		if(t == 0) {
+			BRUNEL_COUNT(STEPS_COUNTER, length);
+		}
+
+		wait(barrier); //all the spikes of the epoch are known
+
+		if(transport) { //the spikes of all the processes are needed to deliver them
+			if(t == 0) {
+				exchange(epoch, length, record);
+			}
+			wait(barrier);
+			if(failed) {
+				break;
+			}
+			{
+				BRUNEL_TIME(DELIVERY_PHASE);
+				for(size_t k(0); k < length; ++k) { //the processes come in order, so the sources are increasing
+					population.deliverSpikes(epoch+k, received[k], bounds[t], bounds[t+1]);
+				}
+			}
+			wait(barrier);
+			continue;
+		}
+
+		if(t == 0) { //the thread 0 gives the spikes of each step to the recorders
+			BRUNEL_TIME(RECORD_PHASE);
+			for(size_t k(0); k < length; ++k) {
+				for(auto const& lists : spikes) { //the recorders of the population read the lists of the threads in order
+					population.recordSpikes(epoch+k, lists[k]);
+				}
+				if(record) { //the function needs all the spikes of the step in one list
+					stepSpikes.clear();
+					for(auto const& lists : spikes) {
+						stepSpikes.insert(stepSpikes.end(), lists[k].begin(), lists[k].end());
+					}
+					record(epoch+k, stepSpikes);
+				}
+			}
+		}
+
+		//the lists are read in the order of the threads, so the sources of a step come in increasing order
+		{
+			BRUNEL_TIME(DELIVERY_PHASE);
+			for(size_t k(0); k < length; ++k) {
+				sources[t].clear();
+				for(auto const& lists : spikes) {
+					sources[t].insert(sources[t].end(), lists[k].begin(), lists[k].end());
+				}
+				population.deliverSpikes(epoch+k, sources[t], bounds[t], bounds[t+1]);
+			}
+		}
+
+		wait(barrier); //all the ring buffers are filled before the next epoch
+	}
+}
+
+template<typename Real>
+void BasicSimulation<Real>::wait(Barrier& barrier)
+{
+	BRUNEL_TIME(WAIT_PHASE);
+	barrier.wait();
+}
+
+template<typename Real>
+void BasicSimulation<Real>::exchange(unsigned long epoch, unsigned long length, const Recorder& record)
+{
+	//the buffer of the process: the number of spikes of each step, then the spikes of each step
+	local.clear();
+	for(size_t k(0); k < length; ++k) {
+		unsigned long count(0);
+		for(auto const& lists : spikes) {
+			count += lists[k].size();
+		}
+		local.push_back(count);
+	}
+	for(size_t k(0); k < length; ++k) {
+		for(auto const& lists : spikes) {
+			local.insert(local.end(), lists[k].begin(), lists[k].end());
+		}
+	}
+	bool exchanged(false);
+	{
+		BRUNEL_TIME(EXCHANGE_PHASE);
+		exchanged = transport->exchange(local, all);
+	}
+	if(!exchanged) {
+		cerr << "Error exchanging the spikes of the processes" << endl;
+		failed = true;
+		return;
+	}
+
+	received.resize(length);
+	for(auto& list : received) {
+		list.clear();
+	}
+	for(auto const& buffer : all) {
+		assert(buffer.size() >= length);
+		const uint32_t* position(buffer.data()+length);
+		for(size_t k(0); k < length; ++k) {
+			received[k].insert(received[k].end(), position, position+buffer[k]);
+			position += buffer[k];
+		}
+	}
+	BRUNEL_TIME(RECORD_PHASE);
+	for(size_t k(0); k < length; ++k) {
+		population.recordSpikes(epoch+k, received[k]);
+		if(record) {
+			record(epoch+k, received[k]);
+		}
+	}
+}
+
+template class BasicSimulation<double>;
+template class BasicSimulation<float>;
@@ -0,0 +1,147 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include "NeuronPopulation.hpp"
+#include "SpikeTransport.hpp"
+
+/*!
+ * @class Barrier
+ * Class that makes a group of threads wait for each other.
+ * A thread that calls wait() is blocked until all the threads of the group have called it.
+ */
+
+class Barrier {
+
+	public:
+
+	/*!
+     * Constructor of the class Barrier
+     * @param count: the number of threads of the group
+     */
+	Barrier(unsigned int count);
+
+	/*!
+	 * Blocks the thread until all the threads of the group are waiting, then they all continue
+     */
+	void wait();
+
+	private:
+
+	std::mutex guard; //!< protects the counters
+	std::condition_variable condition; //!< the waiting threads sleep on it
+	unsigned int numberThreads; //!< number of threads of the group
+	unsigned int waiting; //!< number of threads waiting at the barrier
+	unsigned long generation; //!< number of times all the threads have passed the barrier
+
+};
+
+/*!
+ * @class BasicSimulation
+ * Class that runs the steps of the simulation of a population on several threads.
+ * All the connections have the same delay D, so a spike can't change any neuron during the D steps after it.
+ * The simulation goes by epochs of D steps: each thread advances its range of neurons (whole blocks of the population)
+ * for the whole epoch with the inputs already in their ring buffers, and keeps the spikes in its own lists.
+ * Once all the threads are done, each thread reads the lists of all the threads and fills the ring buffer of
+ * the targets that are in its own range only, so two threads never write in the same place. The spikes of a step
+ * are delivered together, tile by tile of the range, so the writes stay in the cache. The threads wait
+ * for each other twice per epoch instead of twice per step. The spikes are delivered step by step in increasing
+ * order of the source as in a single thread, so the results are the same whatever the number of threads for a given seed.
+ *
+ * With a SpikeTransport, the population is also shared between several processes: each process only updates its
+ * range and only needs the connections towards it. At each epoch the thread 0 of each process gives the spikes of
+ * its range to the transport and receives the spikes of all the processes, in the order of the processes, so the
+ * spikes are delivered in the same order as in a single process and the results are the same.
+ */
+
+template<typename Real>
+class BasicSimulation {
+
+	public:
+
+	/*!
+	 * Function called at the end of each step with the time and the indexes of the neurons which spiked
+     */
+	typedef std::function<void(unsigned long, const std::vector<uint32_t>&)> Recorder;
+
+	/*!
+     * Constructor of the class BasicSimulation
+     * @param neurons: the population to simulate, with its connectivity
+     * @param threads: the number of threads which share the neurons
+     * @param transport: the exchange of the spikes with the other processes, nullptr if there is only one
+     */
+	BasicSimulation(BasicNeuronPopulation<Real>& neurons, unsigned int threads = 1, SpikeTransport* transport = nullptr);
+
+	/*!
+	 * @param size: the number of neurons; part, parts: a part of the neurons and the number of parts
+	 * Shares whole blocks of neurons as equally as possible between parts (threads or processes)
+	 * @return the first neuron of the part, part=parts gives size
+     */
+	static unsigned long partition(unsigned long size, unsigned long part, unsigned long parts);
+
+	/*!
+	 * Getter for the number of threads of the simulation
+	 * @return numberThreads
+     */
+	unsigned int getThreads() const;
+
+	/*!
+	 * Getter for the first neuron of the range of the thread t
+	 * @return bounds[t], the range of t ends at bounds[t+1]
+     */
+	unsigned long getBound(unsigned int t) const;
+
+	/*!
+	 * @param start, stop: the steps from start to stop (excluded) are simulated
+	 * @param I: the external input current
+	 * @param record: function called with the spikes of each step, in order, at the end of each epoch
+	 * Makes the population evolve, the threads are created for the run and joined at the end. The recorders
+	 * attached to the population receive the spikes at the same time, and the potentials during the updates.
+	 * @return false if the spikes couldn't be exchanged with the other processes
+     */
+	bool run(unsigned long start, unsigned long stop, double I, const Recorder& record);
+
+	private:
+
+	/*!
+	 * @param t: the number of the thread
+	 * Work of one thread during the run, for each epoch: update its range, wait for the others,
+	 * deliver to its range, wait again
+     */
+	void work(unsigned int t, unsigned long start, unsigned long stop, double I, const Recorder& record, Barrier& barrier);
+
+	/*!
+	 * @param barrier: the barrier of the threads
+	 * Waits for the other threads, the time is the wait phase of the instrumentation
+     */
+	static void wait(Barrier& barrier);
+
+	/*!
+	 * @param epoch, length: the first step and the number of steps of the epoch
+	 * Work of the thread 0 with a transport: exchanges the spikes of the epoch with the other processes,
+	 * fills received with the spikes of all the processes and gives them to the recorders
+     */
+	void exchange(unsigned long epoch, unsigned long length, const Recorder& record);
+
+	BasicNeuronPopulation<Real>& population; //!< population of neurons that is simulated
+	unsigned int numberThreads; //!< number of threads of the simulation
+	std::vector<unsigned long> bounds; //!< first neuron of each thread, and the size of the population at the end
+	std::vector<std::vector<std::vector<uint32_t> > > spikes; //!< spikes found by each thread, for each step of the current epoch
+	std::vector<uint32_t> stepSpikes; //!< all the spikes of the current step, given to the recorder
+	std::vector<std::vector<uint32_t> > sources; //!< all the spikes of a step gathered by each thread to deliver them
+	SpikeTransport* transport; //!< exchange of the spikes with the other processes, nullptr if there is only one
+	std::vector<uint32_t> local; //!< spikes of the process for the transport
+	std::vector<std::vector<uint32_t> > all; //!< spikes of each process given by the transport
+	std::vector<std::vector<uint32_t> > received; //!< spikes of all the processes for each step of the epoch
+	bool failed; //!< true if the exchange failed, the threads stop
+
+};
+
+typedef BasicSimulation<double> Simulation; //!< simulation of a population in double precision
+typedef BasicSimulation<float> FloatSimulation; //!< simulation of a population in single precision
+
+#endif
@@ -0,0 +1,204 @@
+#include "SpikeAnalysis.hpp"
+#include "Neuron.hpp"
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+
+SpikeAnalysis::SpikeAnalysis(unsigned long size, unsigned long excitatory, unsigned long start, unsigned long stop)
+	:numberNeurons(size), numberExcitatory(excitatory), firstStep(start), lastStep(stop),
+	 histogram((stop-start+binSteps-1)/binSteps, 0), counts(size, 0), lastSpike(size, -1),
+	 intervalMean(size, 0.0), intervalSquares(size, 0.0), totalSpikes(0)
+{
+	assert(start <= stop and excitatory <= size);
+}
+
+void SpikeAnalysis::record(unsigned long step, const vector<uint32_t>& spikes)
+{
+	assert(step >= firstStep and step < lastStep);
+	histogram[(step-firstStep)/binSteps] += spikes.size();
+	totalSpikes += spikes.size();
+
+	const bool inRaster(step >= rasterStart and step < rasterStop);
+	for(auto i : spikes) {
+		assert(i < numberNeurons);
+		if(lastSpike[i] >= 0) { //one more interval, the mean and the variance are updated (Welford)
+			const double interval(step-lastSpike[i]);
+			const double delta(interval-intervalMean[i]);
+			intervalMean[i] += delta/counts[i]; //counts[i] is the number of intervals with this one
+			intervalSquares[i] += delta*(interval-intervalMean[i]);
+		}
+		lastSpike[i] = step;
+		++counts[i];
+
+		if(inRaster and i < rasterNeurons) {
+			raster.push_back(step);
+			raster.push_back(i);
+		}
+	}
+}
+
+////////////////GETTERS//////////////////////
+
+const vector<unsigned long>& SpikeAnalysis::getHistogram() const
+{
+	return histogram;
+}
+
+unsigned long SpikeAnalysis::getTotalSpikes() const
+{
+	return totalSpikes;
+}
+
+double SpikeAnalysis::getRate(unsigned long i) const
+{
+	const double duration((lastStep-firstStep)*h/1000.0); //in seconds
+	return counts[i]/duration;
+}
+
+double SpikeAnalysis::getMeanRate(unsigned long first, unsigned long last) const
+{
+	double sum(0.0);
+	for(size_t i(first); i < last; ++i) {
+		sum += getRate(i);
+	}
+	return (last > first) ? sum/(last-first) : 0.0;
+}
+
+double SpikeAnalysis::getCV(unsigned long i) const
+{
+	if(counts[i] < 3) { //less than 2 intervals
+		return NAN;
+	}
+	const double variance(intervalSquares[i]/(counts[i]-1));
+	return sqrt(variance)/intervalMean[i];
+}
+
+double SpikeAnalysis::getMeanCV(unsigned long first, unsigned long last) const
+{
+	double sum(0.0);
+	unsigned long number(0);
+	for(size_t i(first); i < last; ++i) {
+		const double cv(getCV(i));
+		if(!std::isnan(cv)) {
+			sum += cv;
+			++number;
+		}
+	}
+	return (number > 0) ? sum/number : NAN;
+}
+
+size_t SpikeAnalysis::getFirstBin() const
+{
+	return min<size_t>(transientSteps/binSteps, histogram.size()/2);
+}
+
+void SpikeAnalysis::getMoments(double& mean, double& variance) const
+{
+	const size_t first(getFirstBin());
+	const size_t bins(max<size_t>(histogram.size()-first, 1));
+	mean = 0.0;
+	variance = 0.0;
+	for(size_t b(first); b < histogram.size(); ++b) {
+		mean += histogram[b];
+	}
+	mean /= bins;
+	for(size_t b(first); b < histogram.size(); ++b) {
+		variance += (histogram[b]-mean)*(histogram[b]-mean);
+	}
+	variance /= bins;
+}
+
+double SpikeAnalysis::getSynchrony() const
+{
+	double mean(0.0), variance(0.0);
+	getMoments(mean, variance);
+	return (mean > 0.0) ? variance/mean : 0.0;
+}
+
+double SpikeAnalysis::getFrequency() const
+{
+	constexpr double peak(0.1); //smallest correlation of a peak
+	double mean(0.0), variance(0.0);
+	getMoments(mean, variance);
+	if(variance == 0.0) {
+		return 0.0;
+	}
+
+	//correlation of the activity with itself lag bins later, until the first peak; the peaks of the spikes which
+	//arrive one delay later are not oscillations of the population
+	const size_t first(getFirstBin());
+	const size_t bins(histogram.size()-first);
+	const size_t shortest(D/binSteps+2);
+	vector<double> correlation(bins/2+1, 0.0);
+	for(size_t lag(1); lag < correlation.size(); ++lag) {
+		for(size_t b(first); b+lag < histogram.size(); ++b) {
+			correlation[lag] += (histogram[b]-mean)*(histogram[b+lag]-mean);
+		}
+		correlation[lag] /= (bins-lag)*variance;
+		if(lag > shortest and correlation[lag-1] > peak and correlation[lag-1] > correlation[lag-2]
+		   and correlation[lag-1] >= correlation[lag]) {
+			return 1000.0/((lag-1)*binSteps*h); //period in ms
+		}
+	}
+	return 0.0;
+}
+
+Regime SpikeAnalysis::getRegime() const
+{
+	if(getMeanCV(0, numberNeurons) < regularCV) {
+		return SYNCHRONOUS_REGULAR;
+	} else if(getSynchrony() < asynchronousSynchrony) {
+		return ASYNCHRONOUS_IRREGULAR;
+	}
+	return (getFrequency() >= fastFrequency) ? SYNCHRONOUS_IRREGULAR_FAST : SYNCHRONOUS_IRREGULAR_SLOW;
+}
+
+const char* SpikeAnalysis::getName(Regime regime)
+{
+	const char* const names[] = {"SR", "AI", "SI fast", "SI slow"};
+	return names[regime];
+}
+
+const vector<uint32_t>& SpikeAnalysis::getRaster() const
+{
+	return raster;
+}
+
+bool SpikeAnalysis::write(const string& prefix) const
+{
+	ofstream histogramFile(prefix+"histogram.txt");
+	ofstream ratesFile(prefix+"rates.txt");
+	ofstream rasterFile(prefix+"raster.gdf");
+	ofstream summaryFile(prefix+"summary.txt");
+	if(histogramFile.fail() or ratesFile.fail() or rasterFile.fail() or summaryFile.fail()) {
+		cerr << "Error opening the files of the results " << prefix << endl;
+		return false;
+	}
+
+	for(size_t b(0); b < histogram.size(); ++b) { //time of the beginning of the bin in ms
+		histogramFile << (firstStep+b*binSteps)*h << '\t' << histogram[b] << '\n';
+	}
+
+	for(size_t i(0); i < numberNeurons; ++i) {
+		ratesFile << i << '\t' << getRate(i) << '\t' << getCV(i) << '\n';
+	}
+
+	for(size_t s(0); s < raster.size(); s += 2) {
+		rasterFile << raster[s] << '\t' << raster[s+1] << '\n';
+	}
+
+	summaryFile << "steps\t" << lastStep-firstStep << '\n'
+				<< "spikes\t" << totalSpikes << '\n'
+				<< "rate_excitatory\t" << getMeanRate(0, numberExcitatory) << '\n'
+				<< "rate_inhibitory\t" << getMeanRate(numberExcitatory, numberNeurons) << '\n'
+				<< "rate_all\t" << getMeanRate(0, numberNeurons) << '\n'
+				<< "cv_mean\t" << getMeanCV(0, numberNeurons) << '\n'
+				<< "synchrony\t" << getSynchrony() << '\n'
+				<< "frequency\t" << getFrequency() << '\n'
+				<< "regime\t" << getName(getRegime()) << '\n';
+	return true;
+}
@@ -0,0 +1,159 @@
+#ifndef SPIKEANALYSIS_HPP
+#define SPIKEANALYSIS_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+constexpr unsigned long binSteps(5); //!< width of a bin of the histogram of the population activity (0.5 ms)
+constexpr unsigned long rasterNeurons(30); //!< the raster keeps the spikes of the neurons with a lower index
+constexpr unsigned long rasterStart(4000); //!< first step of the raster (400 ms)
+constexpr unsigned long rasterStop(5000); //!< end of the raster (500 ms)
+constexpr unsigned long transientSteps(1000); //!< the activity of the first steps (100 ms) is not used to find the regime
+constexpr double regularCV(0.1); //!< the neurons fire regularly below this mean CV
+constexpr double asynchronousSynchrony(2.0); //!< the population is asynchronous below this synchrony
+constexpr double fastFrequency(100.0); //!< the oscillations of the population are fast above this frequency (Hz)
+
+/*!
+ * regimes of the article: synchronous regular (SR), asynchronous irregular (AI), synchronous irregular with fast
+ * or slow oscillations (SI)
+ */
+enum Regime {SYNCHRONOUS_REGULAR, ASYNCHRONOUS_IRREGULAR, SYNCHRONOUS_IRREGULAR_FAST, SYNCHRONOUS_IRREGULAR_SLOW};
+
+/*!
+ * @class SpikeAnalysis
+ * Class that computes the statistics of the spikes while the simulation runs, instead of reading all the spikes
+ * from a file afterwards. For each step it adds the spikes to the histogram of the population activity, to the number
+ * of spikes of each neuron and to the intervals between the spikes of each neuron (running mean and variance to get
+ * the coefficient of variation). The spikes of a few neurons during a window are kept for a raster plot.
+ * The memory only depends on the number of neurons and of steps, not on the number of spikes.
+ */
+
+class SpikeAnalysis {
+
+	public:
+
+	/*!
+     * Constructor of the class SpikeAnalysis
+     * @param size: the number of neurons; excitatory: the number of excitatory neurons (the first ones)
+     * @param start, stop: the steps of the simulation, from start to stop (excluded)
+     */
+	SpikeAnalysis(unsigned long size, unsigned long excitatory, unsigned long start, unsigned long stop);
+
+	/*!
+	 * @param step: the time of the spikes; spikes: the indexes of the neurons which spiked
+	 * Adds the spikes of a step to the statistics
+     */
+	void record(unsigned long step, const std::vector<uint32_t>& spikes);
+
+	///////////////////////GETTERS////////////////////
+	/*!
+	 * Getter for the histogram of the activity
+	 * @return the number of spikes of each bin of binSteps steps
+     */
+	const std::vector<unsigned long>& getHistogram() const;
+
+	/*!
+	 * Getter for the total number of spikes
+	 * @return the number of spikes recorded
+     */
+	unsigned long getTotalSpikes() const;
+
+	/*!
+	 * @param i: the index of a neuron
+	 * Computes the firing rate of the neuron i during the simulation
+	 * @return the rate in Hz
+     */
+	double getRate(unsigned long i) const;
+
+	/*!
+	 * @param first, last: the neurons from first to last (excluded)
+	 * Computes the mean firing rate of a range of neurons
+	 * @return the rate in Hz
+     */
+	double getMeanRate(unsigned long first, unsigned long last) const;
+
+	/*!
+	 * @param i: the index of a neuron
+	 * Computes the coefficient of variation of the intervals between the spikes of the neuron i
+	 * @return the standard deviation over the mean of the intervals, NAN with less than 2 intervals
+     */
+	double getCV(unsigned long i) const;
+
+	/*!
+	 * @param first, last: the neurons from first to last (excluded)
+	 * Computes the mean coefficient of variation of a range of neurons, the neurons without a CV are ignored
+	 * @return the mean CV, NAN if no neuron of the range has one
+     */
+	double getMeanCV(unsigned long first, unsigned long last) const;
+
+	/*!
+	 * Computes the synchrony of the population after the transient: the variance of the number of spikes
+	 * of the bins of the histogram over their mean, about 1 for independent neurons
+	 * @return the synchrony, 0 without spikes
+     */
+	double getSynchrony() const;
+
+	/*!
+	 * Computes the frequency of the oscillations of the population after the transient, given by the first peak
+	 * of the autocorrelation of the histogram
+	 * @return the frequency in Hz, 0 if the activity doesn't oscillate
+     */
+	double getFrequency() const;
+
+	/*!
+	 * Finds the regime of the network from the mean CV, the synchrony and the frequency
+	 * @return the regime
+     */
+	Regime getRegime() const;
+
+	/*!
+	 * @param regime: a regime
+	 * @return the short name of the regime ("SR", "AI", "SI fast" or "SI slow")
+     */
+	static const char* getName(Regime regime);
+
+	/*!
+	 * Getter for the spikes kept for the raster plot
+	 * @return the time and the index of each spike, one after the other
+     */
+	const std::vector<uint32_t>& getRaster() const;
+
+	/*!
+	 * @param prefix: the beginning of the name of the files
+	 * Writes the results in small text files: prefix+"histogram.txt" (time in ms and spikes of each bin),
+	 * prefix+"rates.txt" (index, rate in Hz and CV of each neuron), prefix+"raster.gdf" (time and index)
+	 * and prefix+"summary.txt" (mean rates and CV of the populations, synchrony, frequency and regime)
+	 * @return false if a file can't be opened
+     */
+	bool write(const std::string& prefix) const;
+
+	private:
+
+	/*!
+	 * @return the first bin of the histogram after the transient, the second half of the bins for a short simulation
+     */
+	size_t getFirstBin() const;
+
+	/*!
+	 * @param mean, variance: receive the mean and the variance of the bins of the histogram after the transient
+     */
+	void getMoments(double& mean, double& variance) const;
+
+	unsigned long numberNeurons; //!< number of neurons
+	unsigned long numberExcitatory; //!< number of excitatory neurons
+	unsigned long firstStep; //!< first step of the simulation
+	unsigned long lastStep; //!< end of the simulation
+
+	std::vector<unsigned long> histogram; //!< number of spikes of each bin
+	std::vector<uint32_t> counts; //!< number of spikes of each neuron
+	std::vector<int64_t> lastSpike; //!< time of the last spike of each neuron, -1 before the first one
+	std::vector<double> intervalMean; //!< running mean of the intervals between the spikes of each neuron
+	std::vector<double> intervalSquares; //!< running sum of the squared differences to the mean (Welford)
+	std::vector<uint32_t> raster; //!< time and index of the spikes of the raster
+	unsigned long totalSpikes; //!< total number of spikes
+
+};
+
+#endif
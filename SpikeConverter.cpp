@@ -0,0 +1,23 @@
+#include "SpikeWriter.hpp"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	//converts the binary file of spikes written by the simulation to the text format used by pythonScript.py
+	string binaryName("spikes.bin");
+	string gdfName("spikes.gdf");
+	if(argc > 1) {
+		binaryName = argv[1];
+	}
+	if(argc > 2) {
+		gdfName = argv[2];
+	}
+	
+	if(!SpikeWriter::convertToGdf(binaryName, gdfName)) {
+		return 1;
+	}
+	return 0;
+}
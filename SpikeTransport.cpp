@@ -0,0 +1,243 @@
+#include "SpikeTransport.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <new>
+#include <csignal>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef BRUNEL_MPI
+#include <mpi.h>
+#endif
+
+using namespace std;
+
+///////////////////////SHARED MEMORY////////////////////
+
+namespace {
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "the barrier of the processes needs atomic integers without locks");
+
+//barrier at the beginning of the shared memory, the atomic integers without locks work between processes
+struct ProcessBarrier {
+	std::atomic<uint32_t> count; //number of processes arrived at the current barrier
+	std::atomic<uint32_t> generation; //number of barriers passed
+	std::atomic<uint32_t> failed; //1 once a process has failed, all the next exchanges fail
+};
+
+const chrono::milliseconds spinTime(2); //time of active waiting at a barrier, then the process sleeps between the checks
+const chrono::seconds barrierTimeout(600); //longest wait at a barrier, a process which is alive but blocked is a failure
+
+}
+
+SharedMemoryTransport::SharedMemoryTransport(unsigned int processes, unsigned long capacity)
+	:numberProcesses(processes > 0 ? processes : 1), slotCapacity(capacity), rank(0), exchanges(0), memory(nullptr),
+	 memorySize(sizeof(ProcessBarrier) + 2*numberProcesses*(capacity+1)*sizeof(uint32_t)), parent(getpid())
+{}
+
+bool SharedMemoryTransport::spawn()
+{
+	//the memory is shared by the processes created after it
+	memory = mmap(nullptr, memorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(memory == MAP_FAILED) {
+		memory = nullptr;
+		cerr << "Error creating the shared memory of the processes" << endl;
+		return false;
+	}
+	ProcessBarrier* const barrier(new(memory) ProcessBarrier);
+	barrier->count.store(0);
+	barrier->generation.store(0);
+	barrier->failed.store(0);
+
+	cout.flush(); //the buffers of the streams would be written by each process
+	parent = getpid();
+	for(unsigned int r(1); r < numberProcesses; ++r) {
+		const pid_t child(fork());
+		if(child < 0) {
+			cerr << "Error creating the process " << r << endl;
+			return false; //the processes already created are stopped by the destructor
+		}
+		if(child == 0) {
+			rank = r;
+			children.clear();
+			return true;
+		}
+		children.push_back(child);
+	}
+	return true;
+}
+
+bool SharedMemoryTransport::wait()
+{
+	bool success(true);
+	for(auto child : children) {
+		int status(0);
+		if(waitpid(child, &status, 0) < 0 or !WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+			success = false;
+		}
+	}
+	children.clear();
+	return success;
+}
+
+unsigned int SharedMemoryTransport::getRank() const
+{
+	return rank;
+}
+
+unsigned int SharedMemoryTransport::getProcesses() const
+{
+	return numberProcesses;
+}
+
+uint32_t* SharedMemoryTransport::slot(unsigned int set, unsigned int process) const
+{
+	uint32_t* const slots(reinterpret_cast<uint32_t*>(static_cast<char*>(memory) + sizeof(ProcessBarrier)));
+	return slots + (set*numberProcesses + process)*(slotCapacity+1);
+}
+
+bool SharedMemoryTransport::othersAlive() const
+{
+	if(rank != 0) { //a process whose parent has ended is given to another one
+		return getppid() == parent;
+	}
+	for(auto child : children) { //the ended processes are left to wait(), which gives their status
+		siginfo_t info;
+		info.si_pid = 0;
+		if(waitid(P_PID, child, &info, WEXITED | WNOHANG | WNOWAIT) != 0 or info.si_pid != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SharedMemoryTransport::synchronize(bool success)
+{
+	ProcessBarrier& barrier(*static_cast<ProcessBarrier*>(memory));
+	if(!success) {
+		barrier.failed.store(1);
+	}
+	const uint32_t generation(barrier.generation.load());
+	if(barrier.count.fetch_add(1)+1 == numberProcesses) { //the last process opens the barrier for the others
+		barrier.count.store(0);
+		barrier.generation.fetch_add(1);
+		return barrier.failed.load() == 0;
+	}
+
+	//the others wait actively for a short time (the usual case), then check the processes between short sleeps
+	const auto start(chrono::steady_clock::now());
+	while(barrier.generation.load() == generation) {
+		if(barrier.failed.load() != 0) {
+			return false;
+		}
+		const auto elapsed(chrono::steady_clock::now()-start);
+		if(elapsed < spinTime) {
+			this_thread::yield();
+			continue;
+		}
+		if((!othersAlive() or elapsed > barrierTimeout) and barrier.generation.load() == generation) {
+			cerr << "The process " << rank << " lost the other processes of the simulation" << endl;
+			barrier.failed.store(1);
+			return false;
+		}
+		this_thread::sleep_for(chrono::microseconds(100));
+	}
+	return barrier.failed.load() == 0;
+}
+
+bool SharedMemoryTransport::exchange(const vector<uint32_t>& local, vector<vector<uint32_t> >& all)
+{
+	assert(memory != nullptr);
+	const unsigned int set(exchanges++%2);
+	uint32_t* const own(slot(set, rank));
+	const bool fits(local.size() <= slotCapacity);
+	if(fits) {
+		own[0] = local.size();
+		copy(local.begin(), local.end(), own+1);
+	} else { //the others are told at the barrier, so all the processes fail together
+		cerr << "Too many spikes for the shared memory in the process " << rank << endl;
+		own[0] = 0;
+	}
+
+	if(!synchronize(fits)) { //all the slots of the set are written
+		return false;
+	}
+
+	all.resize(numberProcesses);
+	for(unsigned int r(0); r < numberProcesses; ++r) {
+		const uint32_t* const other(slot(set, r));
+		all[r].assign(other+1, other+1+other[0]);
+	}
+	return true;
+}
+
+SharedMemoryTransport::~SharedMemoryTransport()
+{
+	//the process 0 ends before wait() after an error, the others could wait for it at a barrier
+	for(auto child : children) {
+		kill(child, SIGTERM);
+	}
+	wait();
+	if(memory != nullptr) {
+		munmap(memory, memorySize);
+	}
+}
+
+///////////////////////MPI////////////////////
+
+#ifdef BRUNEL_MPI
+
+MpiTransport::MpiTransport(int* argc, char*** argv)
+	:rank(0), numberProcesses(1)
+{
+	MPI_Init(argc, argv);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &numberProcesses);
+	sizes.resize(numberProcesses);
+	displacements.resize(numberProcesses);
+}
+
+unsigned int MpiTransport::getRank() const
+{
+	return rank;
+}
+
+unsigned int MpiTransport::getProcesses() const
+{
+	return numberProcesses;
+}
+
+bool MpiTransport::exchange(const vector<uint32_t>& local, vector<vector<uint32_t> >& all)
+{
+	int size(local.size());
+	if(MPI_Allgather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, MPI_COMM_WORLD) != MPI_SUCCESS) {
+		return false;
+	}
+	int total(0);
+	for(int r(0); r < numberProcesses; ++r) {
+		displacements[r] = total;
+		total += sizes[r];
+	}
+	received.resize(total);
+	if(MPI_Allgatherv(local.data(), size, MPI_UINT32_T, received.data(), sizes.data(), displacements.data(),
+					  MPI_UINT32_T, MPI_COMM_WORLD) != MPI_SUCCESS) {
+		return false;
+	}
+	all.resize(numberProcesses);
+	for(int r(0); r < numberProcesses; ++r) {
+		all[r].assign(received.begin()+displacements[r], received.begin()+displacements[r]+sizes[r]);
+	}
+	return true;
+}
+
+MpiTransport::~MpiTransport()
+{
+	MPI_Finalize();
+}
+
+#endif
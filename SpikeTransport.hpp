@@ -0,0 +1,162 @@
+#ifndef SPIKETRANSPORT_HPP
+#define SPIKETRANSPORT_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+
+/*!
+ * @class SpikeTransport
+ * Interface of the exchange of the spikes between the processes of a distributed simulation.
+ * Each process simulates a range of the neurons and, once per epoch, gives the spikes of its range and receives
+ * the spikes of all the processes. The backends only move buffers of 32 bits words, the Simulation chooses what is in them.
+ */
+
+class SpikeTransport {
+
+	public:
+
+	/*!
+	 * Getter for the number of this process, from 0 to getProcesses()-1
+	 * @return rank
+     */
+	virtual unsigned int getRank() const = 0;
+
+	/*!
+	 * Getter for the number of processes of the simulation
+	 * @return numberProcesses
+     */
+	virtual unsigned int getProcesses() const = 0;
+
+	/*!
+	 * @param local: the buffer of this process
+	 * @param all: receives the buffers of all the processes, all[r] is the buffer of the process r
+	 * Gives the buffer of this process to the others and receives theirs, all the processes must call it together
+	 * @return false if the exchange failed
+     */
+	virtual bool exchange(const std::vector<uint32_t>& local, std::vector<std::vector<uint32_t> >& all) = 0;
+
+	/*!
+	 * destructor of the class SpikeTransport
+     */
+	virtual ~SpikeTransport() {}
+
+};
+
+/*!
+ * @class SharedMemoryTransport
+ * Backend for several processes on one machine. A shared memory is created, then the process forks the others,
+ * which share it. Each process has a slot in the memory, it writes its buffer in it, waits at a barrier shared
+ * by the processes and reads the slots of the others. There are two sets of slots used one epoch after the other,
+ * so a process which is ahead never writes in a slot that another one is still reading, and one barrier is enough.
+ * The barrier is made of atomic counters: a process waits actively, then checks that the others are still alive
+ * between short sleeps. A process which fails tells the others at the barrier, so all the exchanges fail together,
+ * and a process which ended (or a wait of 10 minutes) makes the others fail instead of waiting forever.
+ */
+
+class SharedMemoryTransport : public SpikeTransport {
+
+	public:
+
+	/*!
+     * Constructor of the class SharedMemoryTransport
+     * @param processes: the number of processes; capacity: the maximal number of words of a buffer
+     */
+	SharedMemoryTransport(unsigned int processes, unsigned long capacity);
+
+	/*!
+	 * Creates the other processes, after the call the calling process has the rank 0 and the others 1 to processes-1,
+	 * they all continue the program from there
+	 * @return false if the memory or a process couldn't be created
+     */
+	bool spawn();
+
+	/*!
+	 * Waits for the end of the other processes, only for the process 0
+	 * @return false if one of them failed
+     */
+	bool wait();
+
+	virtual unsigned int getRank() const override;
+	virtual unsigned int getProcesses() const override;
+	virtual bool exchange(const std::vector<uint32_t>& local, std::vector<std::vector<uint32_t> >& all) override;
+
+	/*!
+	 * destructor of the class SharedMemoryTransport, the process 0 stops the others if wait() wasn't called
+	 * (after an error), then waits for them
+     */
+	virtual ~SharedMemoryTransport();
+
+	private:
+
+	/*!
+	 * Tells if the other processes can still come to the barrier: its children for the process 0, the process 0
+	 * for the others
+	 * @return false if one of them has ended
+     */
+	bool othersAlive() const;
+
+	/*!
+	 * @param success: false if this process failed, the others fail at the same barrier
+	 * Waits until all the processes are at the barrier
+	 * @return false if a process failed or ended
+     */
+	bool synchronize(bool success);
+
+	/*!
+	 * @return the beginning of the slot of a process in a set of slots (the size then the words)
+     */
+	uint32_t* slot(unsigned int set, unsigned int process) const;
+
+	unsigned int numberProcesses; //!< number of processes
+	unsigned long slotCapacity; //!< maximal number of words of a buffer
+	unsigned int rank; //!< number of this process
+	unsigned long exchanges; //!< number of exchanges made, its parity gives the set of slots
+	void* memory; //!< shared memory: the barrier then the slots
+	size_t memorySize; //!< size of the shared memory in bytes
+	pid_t parent; //!< the process 0
+	std::vector<pid_t> children; //!< other processes, for the process 0
+
+};
+
+#ifdef BRUNEL_MPI
+
+/*!
+ * @class MpiTransport
+ * Backend for processes started by mpirun, on one or several machines. The sizes of the buffers are gathered
+ * first, then the buffers with MPI_Allgatherv.
+ */
+
+class MpiTransport : public SpikeTransport {
+
+	public:
+
+	/*!
+     * Constructor of the class MpiTransport, initializes MPI
+     * @param argc, argv: the arguments of the program
+     */
+	MpiTransport(int* argc, char*** argv);
+
+	virtual unsigned int getRank() const override;
+	virtual unsigned int getProcesses() const override;
+	virtual bool exchange(const std::vector<uint32_t>& local, std::vector<std::vector<uint32_t> >& all) override;
+
+	/*!
+	 * destructor of the class MpiTransport, finalizes MPI
+     */
+	virtual ~MpiTransport();
+
+	private:
+
+	int rank; //!< number of this process
+	int numberProcesses; //!< number of processes
+	std::vector<int> sizes; //!< size of the buffer of each process
+	std::vector<int> displacements; //!< position of the buffer of each process in the received words
+	std::vector<uint32_t> received; //!< buffers of all the processes, one after the other
+
+};
+
+#endif
+
+#endif
@@ -0,0 +1,235 @@
+#include "SpikeWriter.hpp"
+#include "BinaryIO.hpp"
+#include "Instrumentation.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+
+using namespace std;
+
+constexpr char magic[4] = {'B', 'R', 'S', 'P'}; //!< first bytes of a binary file of spikes
+constexpr uint32_t version(1); //!< version of the format
+constexpr size_t bufferSize(1 << 18); //!< size of a buffer of the simulation before it is given to the writer thread
+
+namespace {
+
+	/*!
+	 * Appends a number to the data, 7 bits per byte, the highest bit tells if another byte follows
+     */
+	void putNumber(vector<uint8_t>& data, uint64_t x)
+	{
+		while(x >= 0x80) {
+			data.push_back(static_cast<uint8_t>(x) | 0x80);
+			x >>= 7;
+		}
+		data.push_back(static_cast<uint8_t>(x));
+	}
+
+	/*!
+	 * Reads a number written by putNumber at the position p, which moves after it
+	 * @return false if the data ends before the number
+     */
+	bool getNumber(const vector<uint8_t>& data, size_t& p, uint64_t& x)
+	{
+		x = 0;
+		for(int shift(0); p < data.size() and shift < 64; shift += 7) {
+			const uint8_t byte(data[p++]);
+			x |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+}
+
+SpikeWriter::SpikeWriter(const string& fileName)
+	:file(fileName, ios::binary), full(false), finished(false), blockCount(0), firstTime(0), previousTime(0), previousIndex(0)
+{
+	if(file.fail()) {
+		return;
+	}
+	file.write(magic, sizeof(magic));
+	writeValue(file, version);
+	writeValue(file, spikesPerBlock);
+
+	filling.reserve(bufferSize);
+	writing.reserve(bufferSize);
+	writer = thread(&SpikeWriter::work, this);
+}
+
+bool SpikeWriter::isOpen() const
+{
+	return !file.fail();
+}
+
+void SpikeWriter::write(unsigned long step, const vector<uint32_t>& spikes)
+{
+	if(spikes.empty() or !writer.joinable()) {
+		return;
+	}
+	filling.push_back(step);
+	filling.push_back(spikes.size());
+	filling.insert(filling.end(), spikes.begin(), spikes.end());
+
+	if(filling.size() >= bufferSize) {
+		handOver();
+	}
+}
+
+void SpikeWriter::handOver()
+{
+	unique_lock<mutex> lock(guard);
+	condition.wait(lock, [this] { return !full; }); //the previous buffer has been written
+	swap(filling, writing);
+	full = true;
+	condition.notify_all();
+	lock.unlock();
+	filling.clear();
+}
+
+bool SpikeWriter::close()
+{
+	if(!writer.joinable()) {
+		return !file.fail();
+	}
+	if(!filling.empty()) {
+		handOver();
+	}
+	{
+		lock_guard<mutex> lock(guard);
+		finished = true;
+	}
+	condition.notify_all();
+	writer.join();
+	file.close();
+	if(file.fail()) { //the errors of the writer thread (a full disk) are kept in the state of the file
+		cerr << "Error writing the binary file of spikes" << endl;
+		return false;
+	}
+	return true;
+}
+
+void SpikeWriter::work()
+{
+	unique_lock<mutex> lock(guard);
+	while(true) {
+		condition.wait(lock, [this] { return full or finished; });
+		if(full) {
+			lock.unlock(); //the simulation can fill the other buffer meanwhile
+			{
+				BRUNEL_TIME(WRITE_PHASE);
+				encode(writing);
+			}
+			writing.clear();
+			lock.lock();
+			full = false;
+			condition.notify_all();
+		} else {
+			break; //finished and nothing more to write
+		}
+	}
+	lock.unlock();
+	if(blockCount > 0) {
+		writeBlock();
+	}
+	file.flush();
+}
+
+void SpikeWriter::encode(const vector<uint32_t>& steps)
+{
+	size_t p(0);
+	while(p < steps.size()) {
+		const uint64_t time(steps[p]);
+		const uint32_t count(steps[p+1]);
+		p += 2;
+		assert(p+count <= steps.size());
+
+		for(uint32_t s(0); s < count; ++s, ++p) {
+			const uint32_t index(steps[p]);
+			if(blockCount == 0) { //the first spike of a block is relative to the time of the block
+				firstTime = time;
+				previousTime = time;
+				putNumber(block, 0);
+				putNumber(block, index);
+			} else if(time == previousTime) { //same step: the indexes are increasing
+				assert(index >= previousIndex);
+				putNumber(block, 0);
+				putNumber(block, index-previousIndex);
+			} else {
+				putNumber(block, time-previousTime);
+				putNumber(block, index);
+			}
+			previousTime = time;
+			previousIndex = index;
+
+			if(++blockCount == spikesPerBlock) {
+				writeBlock();
+			}
+		}
+	}
+}
+
+void SpikeWriter::writeBlock()
+{
+	writeValue(file, blockCount);
+	writeValue(file, static_cast<uint32_t>(block.size()));
+	writeValue(file, firstTime);
+	file.write(reinterpret_cast<const char*>(block.data()), block.size());
+	BRUNEL_COUNT(BYTES_COUNTER, 2*sizeof(uint32_t)+sizeof(uint64_t)+block.size());
+	block.clear();
+	blockCount = 0;
+}
+
+bool SpikeWriter::convertToGdf(const string& binaryName, const string& gdfName)
+{
+	ifstream in(binaryName, ios::binary);
+	ofstream out(gdfName);
+	if(in.fail() or out.fail()) {
+		cerr << "Error opening the files " << binaryName << " and " << gdfName << endl;
+		return false;
+	}
+
+	char header[4];
+	uint32_t fileVersion(0), fileBlock(0);
+	if(!in.read(header, sizeof(header)) or !equal(header, header+4, magic) or !readValue(in, fileVersion)
+	   or fileVersion != version or !readValue(in, fileBlock)) {
+		cerr << binaryName << " is not a binary file of spikes" << endl;
+		return false;
+	}
+
+	uint32_t count(0), bytes(0);
+	uint64_t time(0);
+	vector<uint8_t> data;
+	while(readValue(in, count)) {
+		if(!readValue(in, bytes) or !readValue(in, time)) {
+			cerr << "Truncated block in " << binaryName << endl;
+			return false;
+		}
+		data.resize(bytes);
+		if(!in.read(reinterpret_cast<char*>(data.data()), bytes)) {
+			cerr << "Truncated block in " << binaryName << endl;
+			return false;
+		}
+
+		size_t p(0);
+		uint64_t index(0), delta(0), value(0);
+		for(uint32_t s(0); s < count; ++s) {
+			if(!getNumber(data, p, delta) or !getNumber(data, p, value)) {
+				cerr << "Invalid block in " << binaryName << endl;
+				return false;
+			}
+			//a spike at the same time as the previous one of the block gives the difference of index
+			index = (delta == 0 and s > 0) ? index+value : value;
+			time += delta;
+			out << time << '\t' << index << '\n';
+		}
+	}
+	return true;
+}
+
+SpikeWriter::~SpikeWriter()
+{
+	close();
+}
@@ -0,0 +1,110 @@
+#ifndef SPIKEWRITER_HPP
+#define SPIKEWRITER_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+constexpr uint32_t spikesPerBlock(4096); //!< number of spikes of a full block of the binary file
+
+/*!
+ * @class SpikeWriter
+ * Class that writes the spikes of a simulation in a compact binary file, from a background thread.
+ * The simulation only copies the spikes of each step in a buffer. When it is full, the buffer is swapped with
+ * a second one that the writer thread encodes and writes to the file while the simulation goes on.
+ *
+ * The file starts with "BRSP", the version and the number of spikes of a full block. Then come blocks of at most
+ * spikesPerBlock spikes: a header (number of spikes, size of the data in bytes, time of the first spike, all in the
+ * byte order of the machine) followed by the spikes. Each spike is the difference of time with the previous spike
+ * of the block, then the index of the neuron, or the difference with the previous index when the time is the same.
+ * The numbers are written with 7 bits per byte, so most of the spikes take 2 or 3 bytes instead of a line of text.
+ * convertToGdf gives back the text format "time  index" of spikes.gdf.
+ */
+
+class SpikeWriter {
+
+	public:
+
+	/*!
+     * Constructor of the class SpikeWriter
+     * The file is created and the writer thread is started
+     * @param fileName: the name of the binary file
+     */
+	SpikeWriter(const std::string& fileName);
+
+	/*!
+	 * Tells if the file could be opened
+	 * @return false if there was an error with the file
+     */
+	bool isOpen() const;
+
+	/*!
+	 * @param step: the time of the spikes; spikes: the indexes of the neurons which spiked, in increasing order
+	 * Adds the spikes of a step to the buffer, the steps must be given in increasing order
+     */
+	void write(unsigned long step, const std::vector<uint32_t>& spikes);
+
+	/*!
+	 * Writes the spikes which are still in the buffers and stops the writer thread
+	 * @return false if the file couldn't be opened or written
+     */
+	bool close();
+
+	/*!
+	 * @param binaryName: the name of a binary file of spikes; gdfName: the name of the text file to create
+	 * Converts a binary file to the text format of spikes.gdf, one line "time\tindex" per spike
+	 * @return false if a file can't be opened or the binary file is not valid
+     */
+	static bool convertToGdf(const std::string& binaryName, const std::string& gdfName);
+
+	/*!
+	 * destructor of the class SpikeWriter, closes the file
+     */
+	~SpikeWriter();
+
+	private:
+
+	/*!
+	 * Gives the buffer filled by the simulation to the writer thread, waits if it is still writing the previous one
+     */
+	void handOver();
+
+	/*!
+	 * Work of the writer thread: encode and write each buffer given by the simulation until the end
+     */
+	void work();
+
+	/*!
+	 * @param steps: buffer of steps, each one is the time, the number of spikes and the indexes
+	 * Encodes the spikes of the buffer in the current block, writing the blocks which are full
+     */
+	void encode(const std::vector<uint32_t>& steps);
+
+	/*!
+	 * Writes the current block in the file and starts a new one
+     */
+	void writeBlock();
+
+	std::ofstream file; //!< binary file of the spikes
+	std::vector<uint32_t> filling; //!< buffer filled by the simulation
+	std::vector<uint32_t> writing; //!< buffer encoded by the writer thread
+	bool full; //!< true while the writer thread has a buffer to write
+	bool finished; //!< true when there is nothing more to write
+	std::mutex guard; //!< protects full and finished
+	std::condition_variable condition; //!< the two threads wait on it for each other
+	std::thread writer; //!< the thread which writes in the file
+
+	std::vector<uint8_t> block; //!< encoded spikes of the current block
+	uint32_t blockCount; //!< number of spikes in the current block
+	uint64_t firstTime; //!< time of the first spike of the current block
+	uint64_t previousTime; //!< time of the last spike encoded
+	uint32_t previousIndex; //!< index of the last spike encoded
+
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "Sweep.hpp"
+#include "NeuronPopulation.hpp"
+#include "Simulation.hpp"
+#include "SpikeWriter.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <memory>
+#include <cassert>
+
+using namespace std;
+
+Sweep::Sweep(const Connectivity& connectivity, unsigned long excitatory, unsigned int s, unsigned int threads)
+	:connections(connectivity), numberExcitatory(excitatory), seed(s), numberThreads(threads > 0 ? threads : 1),
+	 next(0), success(true)
+{
+	assert(excitatory <= connections.size());
+}
+
+vector<SweepPoint> Sweep::readPoints(const string& fileName)
+{
+	vector<SweepPoint> points;
+	ifstream file(fileName);
+	if(file.fail()) {
+		cerr << "Error opening the file of the points " << fileName << endl;
+		return points;
+	}
+	SweepPoint point;
+	while(file >> point.g >> point.etha) {
+		points.push_back(point);
+	}
+	return points;
+}
+
+string Sweep::prefix(const SweepPoint& point)
+{
+	ostringstream name;
+	name << "g" << point.g << "_etha" << point.etha << "_";
+	return name.str();
+}
+
+bool Sweep::run(const vector<SweepPoint>& points, unsigned long start, unsigned long stop, double I, bool writeSpikes)
+{
+	sweepPoints = points;
+	analyses.assign(points.size(), SpikeAnalysis(connections.size(), numberExcitatory, start, stop));
+	next = 0;
+	success = true;
+
+	//no more threads than points, the calling thread is one of them
+	const unsigned long numberWorkers(min<unsigned long>(numberThreads, points.size()));
+	vector<thread> threads;
+	for(size_t t(1); t < numberWorkers; ++t) {
+		threads.push_back(thread(&Sweep::work, this, start, stop, I, writeSpikes));
+	}
+	work(start, stop, I, writeSpikes);
+
+	for(auto& th : threads) {
+		th.join();
+	}
+	return success;
+}
+
+void Sweep::work(unsigned long start, unsigned long stop, double I, bool writeSpikes)
+{
+	for(unsigned long p(next++); p < sweepPoints.size(); p = next++) {
+		const string name(prefix(sweepPoints[p]));
+
+		//each point has its own neurons, with the connections of the network
+		NeuronPopulation population(connections.size(), numberExcitatory, seed);
+		population.setG(sweepPoints[p].g);
+		population.setEtha(sweepPoints[p].etha);
+		population.setConnectivity(connections);
+
+		unique_ptr<SpikeWriter> file;
+		if(writeSpikes) {
+			file.reset(new SpikeWriter(name+"spikes.bin"));
+			if(!file->isOpen()) {
+				cerr << "Error opening binary file " << name << "spikes.bin" << endl;
+				success = false;
+				continue;
+			}
+		}
+
+		Simulation simulation(population, 1); //the threads are used for the points, not inside a point
+		SpikeAnalysis& analysis(analyses[p]);
+		simulation.run(start, stop, I, [&](unsigned long n, const vector<uint32_t>& spikes) {
+			analysis.record(n, spikes);
+			if(file) {
+				file->write(n, spikes);
+			}
+		});
+		if(file and !file->close()) {
+			success = false;
+		}
+
+		if(!analysis.write(name)) {
+			success = false;
+		}
+	}
+}
+
+const SpikeAnalysis& Sweep::getAnalysis(unsigned long p) const
+{
+	return analyses[p];
+}
+
+bool Sweep::write(const string& fileName) const
+{
+	ofstream file(fileName);
+	if(file.fail()) {
+		cerr << "Error opening the file of the sweep " << fileName << endl;
+		return false;
+	}
+	file << "g\tetha\trate_excitatory\trate_inhibitory\trate_all\tcv_mean\n";
+	for(size_t p(0); p < sweepPoints.size(); ++p) {
+		const unsigned long size(connections.size());
+		file << sweepPoints[p].g << '\t' << sweepPoints[p].etha << '\t'
+			 << analyses[p].getMeanRate(0, numberExcitatory) << '\t'
+			 << analyses[p].getMeanRate(numberExcitatory, size) << '\t'
+			 << analyses[p].getMeanRate(0, size) << '\t'
+			 << analyses[p].getMeanCV(0, size) << '\n';
+	}
+	return true;
+}
@@ -0,0 +1,101 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "Connectivity.hpp"
+#include "SpikeAnalysis.hpp"
+
+/*!
+ * @file Sweep.hpp
+ * point of the parameter space of the network: relative strength g of the connections and etha
+ */
+struct SweepPoint {
+	double g; //!< relative strenghts of connections g=J_inhibitory/J_excitatory
+	double etha; //!< value of externalFrequency over thresold frequency
+};
+
+/*!
+ * @class Sweep
+ * Class that simulates the same network for several values of (g, etha) at the same time.
+ * The connections are built once and shared by all the points, they are only read during the simulations.
+ * Each point has its own NeuronPopulation with the seed of the network, so a point gives exactly the same
+ * spikes as a normal run with the same seed, g and etha. The points are simulated by a pool of threads:
+ * each thread takes the next point which has not been started, simulates it alone and writes its results
+ * in files starting with the prefix of the point ("g5_etha2_histogram.txt" for instance).
+ */
+
+class Sweep {
+
+	public:
+
+	/*!
+     * Constructor of the class Sweep
+     * @param connectivity: the connections of the network, shared by all the points
+     * @param excitatory: the number of excitatory neurons of the network (the first ones)
+     * @param seed: the seed of the random spikes of the populations
+     * @param threads: the number of points simulated at the same time
+     */
+	Sweep(const Connectivity& connectivity, unsigned long excitatory, unsigned int seed, unsigned int threads = 1);
+
+	/*!
+	 * @param fileName: a text file with one point per line, "g etha"
+	 * Reads the points of a sweep
+	 * @return the points, empty if the file can't be read
+     */
+	static std::vector<SweepPoint> readPoints(const std::string& fileName);
+
+	/*!
+	 * @param point: a point of the sweep
+	 * Gives the beginning of the names of the files of a point
+	 * @return "g"+g+"_etha"+etha+"_"
+     */
+	static std::string prefix(const SweepPoint& point);
+
+	/*!
+	 * @param points: the values of (g, etha) to simulate
+	 * @param start, stop: the steps from start to stop (excluded) are simulated
+	 * @param I: the external input current
+	 * @param writeSpikes: if true, all the spikes of each point are also written in prefix+"spikes.bin"
+	 * Simulates all the points on the threads of the sweep and writes the results of each point
+	 * @return false if a file of the results can't be written
+     */
+	bool run(const std::vector<SweepPoint>& points, unsigned long start, unsigned long stop, double I,
+			 bool writeSpikes = false);
+
+	/*!
+	 * Getter for the statistics of the point p of the last run
+	 * @return the analysis of the spikes of the point
+     */
+	const SpikeAnalysis& getAnalysis(unsigned long p) const;
+
+	/*!
+	 * @param fileName: the name of the file to create
+	 * Writes one line per point of the last run: g, etha, the mean rates of the excitatory, inhibitory and all
+	 * the neurons and the mean CV, to draw a phase diagram
+	 * @return false if the file can't be opened
+     */
+	bool write(const std::string& fileName) const;
+
+	private:
+
+	/*!
+	 * Work of one thread of the pool: simulates the points which have not been started until there is none left
+     */
+	void work(unsigned long start, unsigned long stop, double I, bool writeSpikes);
+
+	const Connectivity& connections; //!< connections of the network, only read
+	unsigned long numberExcitatory; //!< number of excitatory neurons
+	unsigned int seed; //!< seed of the random spikes of each point
+	unsigned int numberThreads; //!< number of points simulated at the same time
+
+	std::vector<SweepPoint> sweepPoints; //!< points of the last run
+	std::vector<SpikeAnalysis> analyses; //!< statistics of the spikes of each point
+	std::atomic<unsigned long> next; //!< next point to simulate
+	std::atomic<bool> success; //!< false if a file couldn't be written
+
+};
+
+#endif
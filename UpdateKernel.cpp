@@ -0,0 +1,330 @@
+#include "UpdateKernel.hpp"
+#include <iostream>
+#include <cassert>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNEL_X86 //the vectorized kernels are only compiled for x86 processors
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+	/*!
+	 * Update of the neurons of the block from the neuron "from" to the end, one neuron at a time.
+	 * It is the reference for the other kernels, which use it for the neurons left at the end of the block.
+     */
+	template<typename Real>
+	void updateScalar(const BasicNeuronBlock<Real>& b, unsigned long from, Real current, vector<uint32_t>& spikingNeurons)
+	{
+		const Real factor(c1); //the constant is rounded to the type of the block
+		for(size_t i(from); i < b.size; ++i) {
+			const int spikeTime(b.spikesOccured[i]);
+			if((spikeTime <= b.clock[i]) and (b.clock[i] < spikeTime+b.refractory) and (spikeTime != 0)) { //refractory
+				b.state[i] = REFRACTORY;
+				b.membranePotential[i] = 0.0;
+			} else if(b.membranePotential[i] >= b.threshold) { //the neuron spikes
+				b.state[i] = REFRACTORY;
+				b.spikesOccured[i] = b.clock[i];
+				++b.spikes[i];
+				spikingNeurons.push_back(b.first+i);
+				b.membranePotential[i] = 0.0;
+			} else {
+				b.state[i] = NON_REFRACTORY;
+				b.membranePotential[i] = factor*b.membranePotential[i] + current + b.input[i] + b.noise[i];
+			}
+			b.input[i] = 0.0;
+			++b.clock[i];
+		}
+	}
+
+#ifdef KERNEL_X86
+
+	/*!
+	 * Writes the states of "lanes" neurons from the mask of the neurons which integrate
+     */
+	inline void storeStates(State* state, unsigned int integrate, unsigned int lanes)
+	{
+		for(unsigned int l(0); l < lanes; ++l) {
+			state[l] = ((integrate >> l) & 1) ? NON_REFRACTORY : REFRACTORY;
+		}
+	}
+
+	/*!
+	 * Registers the spikes of the neurons of the mask, from the neuron i of the block, before their clock is increased
+     */
+	template<typename Real>
+	inline void storeSpikes(const BasicNeuronBlock<Real>& b, unsigned long i, unsigned int fire, vector<uint32_t>& spikingNeurons)
+	{
+		while(fire != 0) {
+			const unsigned long j(i + __builtin_ctz(fire)); //lowest neuron of the mask
+			fire &= fire-1;
+			b.spikesOccured[j] = b.clock[j];
+			++b.spikes[j];
+			spikingNeurons.push_back(b.first+j);
+		}
+	}
+
+	/*!
+	 * Update of the block 4 neurons at a time with AVX2
+     */
+	__attribute__((target("avx2")))
+	void updateAvx2(const BasicNeuronBlock<double>& b, double current, vector<uint32_t>& spikingNeurons)
+	{
+		const __m256d factor(_mm256_set1_pd(c1));
+		const __m256d constant(_mm256_set1_pd(current));
+		const __m256d threshold(_mm256_set1_pd(b.threshold));
+		const __m256d zero(_mm256_setzero_pd());
+		const __m128i zeroInt(_mm_setzero_si128());
+		const __m128i one(_mm_set1_epi32(1));
+		const __m128i period(_mm_set1_epi32(b.refractory-1));
+
+		size_t i(0);
+		for(; i+4 <= b.size; i += 4) {
+			const __m128i spikeTime(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.spikesOccured+i)));
+			const __m128i time(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.clock+i)));
+
+			//not refractory: no spike yet, or the spike is after the clock, or the clock is after the refractory period
+			const __m128i free32(_mm_or_si128(_mm_cmpeq_epi32(spikeTime, zeroInt),
+									_mm_or_si128(_mm_cmpgt_epi32(spikeTime, time),
+												 _mm_cmpgt_epi32(time, _mm_add_epi32(spikeTime, period)))));
+			const __m256d free(_mm256_castsi256_pd(_mm256_cvtepi32_epi64(free32)));
+
+			const __m256d potential(_mm256_loadu_pd(b.membranePotential+i));
+			const __m256d above(_mm256_cmp_pd(potential, threshold, _CMP_GE_OQ));
+			const __m256d integrate(_mm256_andnot_pd(above, free)); //neither refractory nor spiking
+
+			__m256d next(_mm256_add_pd(_mm256_mul_pd(factor, potential), constant));
+			next = _mm256_add_pd(next, _mm256_loadu_pd(b.input+i));
+			next = _mm256_add_pd(next, _mm256_loadu_pd(b.noise+i));
+			_mm256_storeu_pd(b.membranePotential+i, _mm256_and_pd(integrate, next)); //the others go to 0
+			_mm256_storeu_pd(b.input+i, zero);
+
+			const unsigned int fire(_mm256_movemask_pd(_mm256_and_pd(free, above)));
+			if(fire != 0) {
+				storeSpikes(b, i, fire, spikingNeurons);
+			}
+			storeStates(b.state+i, _mm256_movemask_pd(integrate), 4);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(b.clock+i), _mm_add_epi32(time, one));
+		}
+		updateScalar(b, i, current, spikingNeurons);
+	}
+
+	/*!
+	 * Update of the block 8 neurons at a time with AVX-512, the clocks are compared with AVX2
+     */
+	__attribute__((target("avx512f")))
+	void updateAvx512(const BasicNeuronBlock<double>& b, double current, vector<uint32_t>& spikingNeurons)
+	{
+		const __m512d factor(_mm512_set1_pd(c1));
+		const __m512d constant(_mm512_set1_pd(current));
+		const __m512d threshold(_mm512_set1_pd(b.threshold));
+		const __m512d zero(_mm512_setzero_pd());
+		const __m256i zeroInt(_mm256_setzero_si256());
+		const __m256i one(_mm256_set1_epi32(1));
+		const __m256i period(_mm256_set1_epi32(b.refractory-1));
+
+		size_t i(0);
+		for(; i+8 <= b.size; i += 8) {
+			const __m256i spikeTime(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.spikesOccured+i)));
+			const __m256i time(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.clock+i)));
+
+			const __m256i free32(_mm256_or_si256(_mm256_cmpeq_epi32(spikeTime, zeroInt),
+									_mm256_or_si256(_mm256_cmpgt_epi32(spikeTime, time),
+													_mm256_cmpgt_epi32(time, _mm256_add_epi32(spikeTime, period)))));
+			const __mmask8 free(_mm256_movemask_ps(_mm256_castsi256_ps(free32)));
+
+			const __m512d potential(_mm512_loadu_pd(b.membranePotential+i));
+			const __mmask8 above(_mm512_cmp_pd_mask(potential, threshold, _CMP_GE_OQ));
+			const __mmask8 integrate(free & ~above);
+
+			__m512d next(_mm512_add_pd(_mm512_mul_pd(factor, potential), constant));
+			next = _mm512_add_pd(next, _mm512_loadu_pd(b.input+i));
+			next = _mm512_add_pd(next, _mm512_loadu_pd(b.noise+i));
+			_mm512_storeu_pd(b.membranePotential+i, _mm512_maskz_mov_pd(integrate, next));
+			_mm512_storeu_pd(b.input+i, zero);
+
+			const unsigned int fire(free & above);
+			if(fire != 0) {
+				storeSpikes(b, i, fire, spikingNeurons);
+			}
+			storeStates(b.state+i, integrate, 8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(b.clock+i), _mm256_add_epi32(time, one));
+		}
+		updateScalar(b, i, current, spikingNeurons);
+	}
+
+	/*!
+	 * Update of a block in single precision 8 neurons at a time with AVX2
+     */
+	__attribute__((target("avx2")))
+	void updateAvx2(const BasicNeuronBlock<float>& b, float current, vector<uint32_t>& spikingNeurons)
+	{
+		const __m256 factor(_mm256_set1_ps(c1));
+		const __m256 constant(_mm256_set1_ps(current));
+		const __m256 threshold(_mm256_set1_ps(b.threshold));
+		const __m256 zero(_mm256_setzero_ps());
+		const __m256i zeroInt(_mm256_setzero_si256());
+		const __m256i one(_mm256_set1_epi32(1));
+		const __m256i period(_mm256_set1_epi32(b.refractory-1));
+
+		size_t i(0);
+		for(; i+8 <= b.size; i += 8) {
+			const __m256i spikeTime(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.spikesOccured+i)));
+			const __m256i time(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.clock+i)));
+
+			//a 32 bits lane holds the clock and the potential of the same neuron
+			const __m256 free(_mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(spikeTime, zeroInt),
+									_mm256_or_si256(_mm256_cmpgt_epi32(spikeTime, time),
+													_mm256_cmpgt_epi32(time, _mm256_add_epi32(spikeTime, period))))));
+
+			const __m256 potential(_mm256_loadu_ps(b.membranePotential+i));
+			const __m256 above(_mm256_cmp_ps(potential, threshold, _CMP_GE_OQ));
+			const __m256 integrate(_mm256_andnot_ps(above, free));
+
+			__m256 next(_mm256_add_ps(_mm256_mul_ps(factor, potential), constant));
+			next = _mm256_add_ps(next, _mm256_loadu_ps(b.input+i));
+			next = _mm256_add_ps(next, _mm256_loadu_ps(b.noise+i));
+			_mm256_storeu_ps(b.membranePotential+i, _mm256_and_ps(integrate, next));
+			_mm256_storeu_ps(b.input+i, zero);
+
+			const unsigned int fire(_mm256_movemask_ps(_mm256_and_ps(free, above)));
+			if(fire != 0) {
+				storeSpikes(b, i, fire, spikingNeurons);
+			}
+			storeStates(b.state+i, _mm256_movemask_ps(integrate), 8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(b.clock+i), _mm256_add_epi32(time, one));
+		}
+		updateScalar(b, i, current, spikingNeurons);
+	}
+
+	/*!
+	 * Update of a block in single precision 16 neurons at a time with AVX-512
+     */
+	__attribute__((target("avx512f")))
+	void updateAvx512(const BasicNeuronBlock<float>& b, float current, vector<uint32_t>& spikingNeurons)
+	{
+		const __m512 factor(_mm512_set1_ps(c1));
+		const __m512 constant(_mm512_set1_ps(current));
+		const __m512 threshold(_mm512_set1_ps(b.threshold));
+		const __m512 zero(_mm512_setzero_ps());
+		const __m512i zeroInt(_mm512_setzero_si512());
+		const __m512i one(_mm512_set1_epi32(1));
+		const __m512i period(_mm512_set1_epi32(b.refractory-1));
+
+		size_t i(0);
+		for(; i+16 <= b.size; i += 16) {
+			const __m512i spikeTime(_mm512_loadu_si512(b.spikesOccured+i));
+			const __m512i time(_mm512_loadu_si512(b.clock+i));
+
+			const __mmask16 free(_mm512_cmpeq_epi32_mask(spikeTime, zeroInt) | _mm512_cmpgt_epi32_mask(spikeTime, time)
+								 | _mm512_cmpgt_epi32_mask(time, _mm512_add_epi32(spikeTime, period)));
+
+			const __m512 potential(_mm512_loadu_ps(b.membranePotential+i));
+			const __mmask16 above(_mm512_cmp_ps_mask(potential, threshold, _CMP_GE_OQ));
+			const __mmask16 integrate(free & ~above);
+
+			__m512 next(_mm512_add_ps(_mm512_mul_ps(factor, potential), constant));
+			next = _mm512_add_ps(next, _mm512_loadu_ps(b.input+i));
+			next = _mm512_add_ps(next, _mm512_loadu_ps(b.noise+i));
+			_mm512_storeu_ps(b.membranePotential+i, _mm512_maskz_mov_ps(integrate, next));
+			_mm512_storeu_ps(b.input+i, zero);
+
+			const unsigned int fire(free & above);
+			if(fire != 0) {
+				storeSpikes(b, i, fire, spikingNeurons);
+			}
+			storeStates(b.state+i, integrate, 16);
+			_mm512_storeu_si512(b.clock+i, _mm512_add_epi32(time, one));
+		}
+		updateScalar(b, i, current, spikingNeurons);
+	}
+
+#endif
+
+}
+
+template<KernelType kernel, typename Real>
+void UpdateKernel::update(const BasicNeuronBlock<Real>& block, Real current, vector<uint32_t>& spikingNeurons)
+{
+#ifdef KERNEL_X86
+	if(kernel == AVX512_KERNEL) {
+		updateAvx512(block, current, spikingNeurons);
+		return;
+	} else if(kernel == AVX2_KERNEL) {
+		updateAvx2(block, current, spikingNeurons);
+		return;
+	}
+#endif
+	updateScalar(block, 0, current, spikingNeurons);
+}
+
+namespace {
+
+	/*!
+	 * Update of a block with the instruction set of the kernel, in the precision of the block
+     */
+	template<typename Real>
+	void dispatch(KernelType type, const BasicNeuronBlock<Real>& block, Real current, vector<uint32_t>& spikingNeurons)
+	{
+		if(type == AVX512_KERNEL) {
+			UpdateKernel::update<AVX512_KERNEL>(block, current, spikingNeurons);
+		} else if(type == AVX2_KERNEL) {
+			UpdateKernel::update<AVX2_KERNEL>(block, current, spikingNeurons);
+		} else {
+			UpdateKernel::update<SCALAR_KERNEL>(block, current, spikingNeurons);
+		}
+	}
+
+}
+
+UpdateKernel::UpdateKernel(KernelType kernel)
+	:type(supported(kernel) ? kernel : SCALAR_KERNEL) //an unsupported kernel falls back to the scalar one
+{}
+
+KernelType UpdateKernel::best()
+{
+	if(supported(AVX512_KERNEL)) {
+		return AVX512_KERNEL;
+	} else if(supported(AVX2_KERNEL)) {
+		return AVX2_KERNEL;
+	}
+	return SCALAR_KERNEL;
+}
+
+bool UpdateKernel::supported(KernelType kernel)
+{
+#ifdef KERNEL_X86
+	__builtin_cpu_init();
+	switch(kernel) {
+		case AVX512_KERNEL: return __builtin_cpu_supports("avx512f");
+		case AVX2_KERNEL: return __builtin_cpu_supports("avx2");
+		default: return true;
+	}
+#else
+	return kernel == SCALAR_KERNEL;
+#endif
+}
+
+KernelType UpdateKernel::getType() const
+{
+	return type;
+}
+
+void UpdateKernel::update(const BasicNeuronBlock<double>& block, double current, vector<uint32_t>& spikingNeurons) const
+{
+	dispatch(type, block, current, spikingNeurons);
+}
+
+void UpdateKernel::update(const BasicNeuronBlock<float>& block, float current, vector<uint32_t>& spikingNeurons) const
+{
+	dispatch(type, block, current, spikingNeurons);
+}
+
+template void UpdateKernel::update<SCALAR_KERNEL, double>(const BasicNeuronBlock<double>&, double, vector<uint32_t>&);
+template void UpdateKernel::update<AVX2_KERNEL, double>(const BasicNeuronBlock<double>&, double, vector<uint32_t>&);
+template void UpdateKernel::update<AVX512_KERNEL, double>(const BasicNeuronBlock<double>&, double, vector<uint32_t>&);
+template void UpdateKernel::update<SCALAR_KERNEL, float>(const BasicNeuronBlock<float>&, float, vector<uint32_t>&);
+template void UpdateKernel::update<AVX2_KERNEL, float>(const BasicNeuronBlock<float>&, float, vector<uint32_t>&);
+template void UpdateKernel::update<AVX512_KERNEL, float>(const BasicNeuronBlock<float>&, float, vector<uint32_t>&);
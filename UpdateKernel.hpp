@@ -0,0 +1,109 @@
+#ifndef UPDATEKERNEL_HPP
+#define UPDATEKERNEL_HPP
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "Neuron.hpp"
+
+/*! @file UpdateKernel.hpp
+ * instruction sets with which a block of neurons can be updated
+*/
+enum KernelType {SCALAR_KERNEL, AVX2_KERNEL, AVX512_KERNEL};
+
+/*!
+ * @struct BasicNeuronBlock
+ * Arrays of a block of consecutive neurons of a population, all the pointers are on the first neuron of the block.
+ * The neurons of a block are in the same group, they have the same threshold and refractory period.
+ * Real is the type of the membrane potentials and of the inputs, double or float.
+ */
+template<typename Real>
+struct BasicNeuronBlock {
+	unsigned long first; //!< index of the first neuron of the block in the population
+	unsigned long size; //!< number of neurons of the block
+	Real* membranePotential; //!< membrane potentials of the block
+	int* spikesOccured; //!< times of the last spikes of the block
+	int* clock; //!< local clocks of the block
+	State* state; //!< states of the block
+	unsigned int* spikes; //!< numbers of spikes of the block
+	Real* input; //!< ring buffer slot of the current time for the block, it is cleared by the update
+	const Real* noise; //!< random spikes received by each neuron of the block (times the amplitude)
+	Real threshold; //!< membrane potential of a spike, the same for the whole block
+	int refractory; //!< steps of the refractory period, the same for the whole block
+};
+
+typedef BasicNeuronBlock<double> NeuronBlock; //!< block of neurons in double precision
+
+/*!
+ * @class UpdateKernel
+ * Class that makes one step of the update of a block of neurons, the same way as Neuron::update.
+ * The refractory period, the threshold crossing and the new membrane potential are computed for several neurons
+ * at once with AVX2 (4 neurons) or AVX-512 (8 neurons) when the processor has them, the choice is made at runtime.
+ * In single precision a vector holds twice as many neurons (8 with AVX2, 16 with AVX-512).
+ * The branches are replaced by masks: a refractory or spiking neuron goes to 0 and only the neurons which integrate
+ * keep the new potential. The spiking neurons are found in the mask and added to a list of indexes.
+ * The results are exactly the same with all the instruction sets. Each instruction set is also a version of
+ * update compiled for it, which the population chooses once instead of at each block.
+ * The refractory neurons stay lanes of the vectors, a block is never refractory as a whole. With
+ * ACTIVE_NEURONS_SCHEDULING the population only draws the random spikes of the neurons which integrate, the
+ * other lanes get 0.
+ */
+
+class UpdateKernel {
+
+	public:
+
+	/*!
+     * Constructor of the class UpdateKernel
+     * @param kernel: the instruction set to use, it must be supported by the processor
+     */
+	UpdateKernel(KernelType kernel = best());
+
+	/*!
+	 * Finds the best instruction set supported by the processor
+	 * @return AVX512_KERNEL, AVX2_KERNEL or SCALAR_KERNEL
+     */
+	static KernelType best();
+
+	/*!
+	 * @param kernel: an instruction set
+	 * Tells if the processor can run the kernel
+	 * @return true if the kernel is supported
+     */
+	static bool supported(KernelType kernel);
+
+	/*!
+	 * Getter for the instruction set used by the kernel
+	 * @return type
+     */
+	KernelType getType() const;
+
+	/*!
+	 * @param block: the neurons to update
+	 * @param current: the external input current times c2, the same for all the neurons
+	 * @param spikingNeurons: the indexes of the neurons which spike are added to it, in increasing order
+	 * Updates the neurons of the block for one step
+     */
+	void update(const BasicNeuronBlock<double>& block, double current, std::vector<uint32_t>& spikingNeurons) const;
+
+	/*!
+	 * @param block, current, spikingNeurons: the same as for a block in double precision
+	 * Updates the neurons of a block in single precision for one step
+     */
+	void update(const BasicNeuronBlock<float>& block, float current, std::vector<uint32_t>& spikingNeurons) const;
+
+	/*!
+	 * @param block, current, spikingNeurons: the same as for update
+	 * Updates the neurons of the block with the instruction set given at compile time, it must be supported
+	 * by the processor
+     */
+	template<KernelType kernel, typename Real>
+	static void update(const BasicNeuronBlock<Real>& block, Real current, std::vector<uint32_t>& spikingNeurons);
+
+	private:
+
+	KernelType type; //!< instruction set used by the kernel
+
+};
+
+#endif
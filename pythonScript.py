@@ -1,20 +1,23 @@
 import numpy as np
 import matplotlib.pyplot as pl
+import sys
+
+# the files are written by the simulation at the end of the run:
+# raster.gdf has the spikes of the neurons < 30 between 400 and 500 ms (step and index),
+# histogram.txt has the number of spikes of all the neurons in each bin of 0.5 ms (time in ms and number)
+# for a point of a sweep, the beginning of the names is given as argument: python pythonScript.py g5_etha2_
+prefix = sys.argv[1] if len(sys.argv) > 1 else ''
 
 fig = pl.figure()
 
 ax1 = fig.add_subplot(211)
-data = np.genfromtxt('spikes.gdf')
-
-select= np.array([d for d in data if d[1] < 30])
-data1= select.transpose()
+data1 = np.loadtxt(prefix+'raster.gdf', ndmin=2).transpose()
 pl.scatter(0.1*data1[0],data1[1],alpha=0.8, edgecolors='none');
 ax1.set_xlim([400, 500])
 
-select2= np.array([d for d in data])
-data2= select2.transpose()
+data2 = np.loadtxt(prefix+'histogram.txt', ndmin=2).transpose()
 ax2 = fig.add_subplot(212)
-n, bins, patches = ax2.hist(0.1*data2[0], 1000, normed=0, alpha=0.75)
+ax2.bar(data2[0], data2[1], width=0.5, align='edge', alpha=0.75)
 ax2.set_xlim([400, 500])
 ax2.set_ylim([0, 1000])
 pl.show();